@@ -165,11 +165,11 @@ int32 GENERIC_EPS_AppInit(void)
     GENERIC_EPS_AppData.HkTelemetryPkt.DeviceHK.EPSTemperature = 0;
     GENERIC_EPS_AppData.HkTelemetryPkt.DeviceHK.SolarArrayVoltage = 0;
     GENERIC_EPS_AppData.HkTelemetryPkt.DeviceHK.SolarArrayTemperature = 0;
-    for(i = 0; i < 8; i++)
+    memset(GENERIC_EPS_AppData.HkTelemetryPkt.DeviceHK.SwitchMask, 0, GENERIC_EPS_SWITCH_MASK_LEN);
+    for(i = 0; i < GENERIC_EPS_CFG_NUM_SWITCHES; i++)
     {
         GENERIC_EPS_AppData.HkTelemetryPkt.DeviceHK.Switch[i].Voltage = 0;
         GENERIC_EPS_AppData.HkTelemetryPkt.DeviceHK.Switch[i].Current = 0;
-        GENERIC_EPS_AppData.HkTelemetryPkt.DeviceHK.Switch[i].Status = 0;
     }
 
     /*
@@ -20,6 +20,7 @@
     #define GENERIC_EPS_CFG_I2C_SPEED        1000
     #define GENERIC_EPS_CFG_I2C_ADDRESS      0x2B // 7-bit address
     #define GENERIC_EPS_CFG_I2C_TIMEOUT      10
+    #define GENERIC_EPS_CFG_NUM_SWITCHES     8  // Must match physical.switch-count of the simulator
     /* Note: Debug flag disabled (commented out) by default */
     //#define GENERIC_EPS_CFG_DEBUG
 #endif
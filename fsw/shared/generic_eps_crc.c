@@ -0,0 +1,188 @@
+/*******************************************************************************
+** File: generic_eps_crc.c
+**
+** Purpose:
+**   This file contains the source code for the GENERIC_EPS CRC8.
+**
+**   The lookup tables are generated by the preprocessor. The CRC is linear,
+**   so each table entry is the XOR of the entries for its set bits and only
+**   eight basis values per table need the bit-by-bit calculation. Table k
+**   holds the CRC of a byte followed by k zero bytes, which is what the
+**   slicing variants consume.
+**
+*******************************************************************************/
+
+/*
+** Include Files
+*/
+#include "generic_eps_crc.h"
+
+
+/*
+** Table generation
+*/
+#define GENERIC_EPS_CRC8_STEP(c) ((((c) & 0x80) != 0) ? ((((c) << 1) ^ GENERIC_EPS_CRC8_POLY) & 0xFF) : (((c) << 1) & 0xFF))
+#define GENERIC_EPS_CRC8_BYTE(c) \
+    GENERIC_EPS_CRC8_STEP(GENERIC_EPS_CRC8_STEP(GENERIC_EPS_CRC8_STEP(GENERIC_EPS_CRC8_STEP( \
+    GENERIC_EPS_CRC8_STEP(GENERIC_EPS_CRC8_STEP(GENERIC_EPS_CRC8_STEP(GENERIC_EPS_CRC8_STEP(c))))))))
+
+#define GENERIC_EPS_CRC8_BASIS(k, p) \
+    GENERIC_EPS_CRC8_S##k##_0 = GENERIC_EPS_CRC8_BYTE(p##_0), \
+    GENERIC_EPS_CRC8_S##k##_1 = GENERIC_EPS_CRC8_BYTE(p##_1), \
+    GENERIC_EPS_CRC8_S##k##_2 = GENERIC_EPS_CRC8_BYTE(p##_2), \
+    GENERIC_EPS_CRC8_S##k##_3 = GENERIC_EPS_CRC8_BYTE(p##_3), \
+    GENERIC_EPS_CRC8_S##k##_4 = GENERIC_EPS_CRC8_BYTE(p##_4), \
+    GENERIC_EPS_CRC8_S##k##_5 = GENERIC_EPS_CRC8_BYTE(p##_5), \
+    GENERIC_EPS_CRC8_S##k##_6 = GENERIC_EPS_CRC8_BYTE(p##_6), \
+    GENERIC_EPS_CRC8_S##k##_7 = GENERIC_EPS_CRC8_BYTE(p##_7)
+
+/* Table k entry for byte value 1 << i */
+enum
+{
+    GENERIC_EPS_CRC8_S0_0 = GENERIC_EPS_CRC8_BYTE(0x01),
+    GENERIC_EPS_CRC8_S0_1 = GENERIC_EPS_CRC8_BYTE(0x02),
+    GENERIC_EPS_CRC8_S0_2 = GENERIC_EPS_CRC8_BYTE(0x04),
+    GENERIC_EPS_CRC8_S0_3 = GENERIC_EPS_CRC8_BYTE(0x08),
+    GENERIC_EPS_CRC8_S0_4 = GENERIC_EPS_CRC8_BYTE(0x10),
+    GENERIC_EPS_CRC8_S0_5 = GENERIC_EPS_CRC8_BYTE(0x20),
+    GENERIC_EPS_CRC8_S0_6 = GENERIC_EPS_CRC8_BYTE(0x40),
+    GENERIC_EPS_CRC8_S0_7 = GENERIC_EPS_CRC8_BYTE(0x80),
+    GENERIC_EPS_CRC8_BASIS(1, GENERIC_EPS_CRC8_S0),
+    GENERIC_EPS_CRC8_BASIS(2, GENERIC_EPS_CRC8_S1),
+    GENERIC_EPS_CRC8_BASIS(3, GENERIC_EPS_CRC8_S2),
+    GENERIC_EPS_CRC8_BASIS(4, GENERIC_EPS_CRC8_S3),
+    GENERIC_EPS_CRC8_BASIS(5, GENERIC_EPS_CRC8_S4),
+    GENERIC_EPS_CRC8_BASIS(6, GENERIC_EPS_CRC8_S5),
+    GENERIC_EPS_CRC8_BASIS(7, GENERIC_EPS_CRC8_S6)
+};
+
+#define GENERIC_EPS_CRC8_ENTRY(k, x) ( \
+    (((x) & 0x01) ? GENERIC_EPS_CRC8_S##k##_0 : 0) ^ (((x) & 0x02) ? GENERIC_EPS_CRC8_S##k##_1 : 0) ^ \
+    (((x) & 0x04) ? GENERIC_EPS_CRC8_S##k##_2 : 0) ^ (((x) & 0x08) ? GENERIC_EPS_CRC8_S##k##_3 : 0) ^ \
+    (((x) & 0x10) ? GENERIC_EPS_CRC8_S##k##_4 : 0) ^ (((x) & 0x20) ? GENERIC_EPS_CRC8_S##k##_5 : 0) ^ \
+    (((x) & 0x40) ? GENERIC_EPS_CRC8_S##k##_6 : 0) ^ (((x) & 0x80) ? GENERIC_EPS_CRC8_S##k##_7 : 0))
+
+#define GENERIC_EPS_CRC8_ROW4(k, n)   GENERIC_EPS_CRC8_ENTRY(k, (n)),     GENERIC_EPS_CRC8_ENTRY(k, (n) + 1), \
+                                      GENERIC_EPS_CRC8_ENTRY(k, (n) + 2), GENERIC_EPS_CRC8_ENTRY(k, (n) + 3)
+#define GENERIC_EPS_CRC8_ROW16(k, n)  GENERIC_EPS_CRC8_ROW4(k, (n)),      GENERIC_EPS_CRC8_ROW4(k, (n) + 4), \
+                                      GENERIC_EPS_CRC8_ROW4(k, (n) + 8),  GENERIC_EPS_CRC8_ROW4(k, (n) + 12)
+#define GENERIC_EPS_CRC8_ROW64(k, n)  GENERIC_EPS_CRC8_ROW16(k, (n)),     GENERIC_EPS_CRC8_ROW16(k, (n) + 16), \
+                                      GENERIC_EPS_CRC8_ROW16(k, (n) + 32), GENERIC_EPS_CRC8_ROW16(k, (n) + 48)
+#define GENERIC_EPS_CRC8_ROW256(k)    { GENERIC_EPS_CRC8_ROW64(k, 0),     GENERIC_EPS_CRC8_ROW64(k, 64), \
+                                        GENERIC_EPS_CRC8_ROW64(k, 128),   GENERIC_EPS_CRC8_ROW64(k, 192) }
+
+static const uint8_t GENERIC_EPS_CRC8_TABLE[8][256] =
+{
+    GENERIC_EPS_CRC8_ROW256(0),
+    GENERIC_EPS_CRC8_ROW256(1),
+    GENERIC_EPS_CRC8_ROW256(2),
+    GENERIC_EPS_CRC8_ROW256(3),
+    GENERIC_EPS_CRC8_ROW256(4),
+    GENERIC_EPS_CRC8_ROW256(5),
+    GENERIC_EPS_CRC8_ROW256(6),
+    GENERIC_EPS_CRC8_ROW256(7)
+};
+
+
+/*
+** CRC8 of a complete payload
+*/
+uint8_t GENERIC_EPS_CRC8(const uint8_t* payload, uint32_t length)
+{
+    return GENERIC_EPS_CRC8_Update(GENERIC_EPS_CRC8_INIT, payload, length);
+}
+
+
+/*
+** Continue a CRC8 from a previous state, picking the variant by length
+*/
+uint8_t GENERIC_EPS_CRC8_Update(uint8_t crc, const uint8_t* payload, uint32_t length)
+{
+    if (length >= GENERIC_EPS_CRC8_SLICE_MIN_LEN)
+    {
+        return GENERIC_EPS_CRC8_Slice8(crc, payload, length);
+    }
+    return GENERIC_EPS_CRC8_Table(crc, payload, length);
+}
+
+
+/*
+** One table lookup per byte
+*/
+uint8_t GENERIC_EPS_CRC8_Table(uint8_t crc, const uint8_t* payload, uint32_t length)
+{
+    uint32_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        crc = GENERIC_EPS_CRC8_TABLE[0][crc ^ payload[i]];
+    }
+    return crc;
+}
+
+
+/*
+** Four bytes per iteration
+*/
+uint8_t GENERIC_EPS_CRC8_Slice4(uint8_t crc, const uint8_t* payload, uint32_t length)
+{
+    while (length >= 4)
+    {
+        crc = GENERIC_EPS_CRC8_TABLE[3][crc ^ payload[0]] ^
+              GENERIC_EPS_CRC8_TABLE[2][payload[1]] ^
+              GENERIC_EPS_CRC8_TABLE[1][payload[2]] ^
+              GENERIC_EPS_CRC8_TABLE[0][payload[3]];
+        payload += 4;
+        length -= 4;
+    }
+    return GENERIC_EPS_CRC8_Table(crc, payload, length);
+}
+
+
+/*
+** Eight bytes per iteration
+*/
+uint8_t GENERIC_EPS_CRC8_Slice8(uint8_t crc, const uint8_t* payload, uint32_t length)
+{
+    while (length >= 8)
+    {
+        crc = GENERIC_EPS_CRC8_TABLE[7][crc ^ payload[0]] ^
+              GENERIC_EPS_CRC8_TABLE[6][payload[1]] ^
+              GENERIC_EPS_CRC8_TABLE[5][payload[2]] ^
+              GENERIC_EPS_CRC8_TABLE[4][payload[3]] ^
+              GENERIC_EPS_CRC8_TABLE[3][payload[4]] ^
+              GENERIC_EPS_CRC8_TABLE[2][payload[5]] ^
+              GENERIC_EPS_CRC8_TABLE[1][payload[6]] ^
+              GENERIC_EPS_CRC8_TABLE[0][payload[7]];
+        payload += 8;
+        length -= 8;
+    }
+    return GENERIC_EPS_CRC8_Table(crc, payload, length);
+}
+
+
+/*
+** Generic slow CRC8 calculator, kept as the reference implementation
+*/
+uint8_t GENERIC_EPS_CRC8_Bitwise(uint8_t crc, const uint8_t* payload, uint32_t length)
+{
+    uint32_t i;
+    uint32_t j;
+
+    for (i = 0; i < length; i++)
+    {
+        crc ^= payload[i];
+        for (j = 0; j < 8; j++)
+        {
+            if ((crc & 0x80) != 0)
+            {
+                crc = (uint8_t)((crc << 1) ^ GENERIC_EPS_CRC8_POLY);
+            }
+            else
+            {
+                crc <<= 1;
+            }
+        }
+    }
+    return crc;
+}
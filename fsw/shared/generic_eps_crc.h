@@ -0,0 +1,43 @@
+/*******************************************************************************
+** File: generic_eps_crc.h
+**
+** Purpose:
+**   This is the header file for the GENERIC_EPS CRC8 (poly 0x31, init 0xFF).
+**   Shared by the flight software and the simulator.
+**
+*******************************************************************************/
+#ifndef _GENERIC_EPS_CRC_H_
+#define _GENERIC_EPS_CRC_H_
+
+/*
+** Required header files.
+*/
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+** Defines
+*/
+#define GENERIC_EPS_CRC8_POLY           0x31
+#define GENERIC_EPS_CRC8_INIT           0xFF
+#define GENERIC_EPS_CRC8_SLICE_MIN_LEN  16 /* Below this the byte table is faster */
+
+
+/*
+** Prototypes
+*/
+uint8_t GENERIC_EPS_CRC8(const uint8_t* payload, uint32_t length);
+uint8_t GENERIC_EPS_CRC8_Update(uint8_t crc, const uint8_t* payload, uint32_t length);
+uint8_t GENERIC_EPS_CRC8_Table(uint8_t crc, const uint8_t* payload, uint32_t length);
+uint8_t GENERIC_EPS_CRC8_Slice4(uint8_t crc, const uint8_t* payload, uint32_t length);
+uint8_t GENERIC_EPS_CRC8_Slice8(uint8_t crc, const uint8_t* payload, uint32_t length);
+uint8_t GENERIC_EPS_CRC8_Bitwise(uint8_t crc, const uint8_t* payload, uint32_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _GENERIC_EPS_CRC_H_ */
@@ -12,34 +12,6 @@
 #include "generic_eps_device.h"
 
 
-/*
-** Generic slow CRC8 calculator
-*/
-uint8_t GENERIC_EPS_CRC8(uint8_t* payload, uint32_t length)
-{
-    uint8_t crc = 0xFF;
-    uint32_t i;
-    uint32_t j;
-
-    for (i = 0; i < length; i++) 
-    {
-        crc ^= payload[i];
-        for (j = 0; j < 8; j++) 
-        {
-            if ((crc & 0x80) != 0)
-            {
-                crc = (uint8_t)((crc << 1) ^ 0x31);
-            }
-            else
-            {
-                crc <<= 1;
-            }
-        }
-    }
-    return crc;
-}
-
-
 /* 
 ** Generic command to device
 ** Note that confirming the echoed response is specific to this implementation
@@ -83,7 +55,7 @@ int32_t GENERIC_EPS_RequestHK(i2c_bus_info_t* device, GENERIC_EPS_Device_HK_tlm_
     uint8_t write_data[3] = {0};
     uint8_t read_data[GENERIC_EPS_DEVICE_HK_LEN+1] = {0};
     uint8_t calc_crc = 0;
-    uint8_t offset = 16;
+    uint16_t offset = 16;
 
     /* Prepare command */
     write_data[0] = 0x70;
@@ -112,12 +84,14 @@ int32_t GENERIC_EPS_RequestHK(i2c_bus_info_t* device, GENERIC_EPS_Device_HK_tlm_
         data->SolarArrayVoltage     = (read_data[12] << 8) | read_data[13];
         data->SolarArrayTemperature = (read_data[14] << 8) | read_data[15];
 
-        for(uint8_t i = 0; i < 8; i++)
+        memcpy(data->SwitchMask, &read_data[offset], GENERIC_EPS_SWITCH_MASK_LEN);
+        offset = offset + GENERIC_EPS_SWITCH_MASK_LEN;
+
+        for(uint8_t i = 0; i < GENERIC_EPS_CFG_NUM_SWITCHES; i++)
         {
             data->Switch[i].Voltage = (read_data[offset] << 8)   | read_data[offset+1];
             data->Switch[i].Current = (read_data[offset+2] << 8) | read_data[offset+3];
-            data->Switch[i].Status  = (read_data[offset+4] << 8) | read_data[offset+5];
-            offset = offset + 6;
+            offset = offset + 4;
         }
     }
     else
@@ -130,7 +104,7 @@ int32_t GENERIC_EPS_RequestHK(i2c_bus_info_t* device, GENERIC_EPS_Device_HK_tlm_
 
     #ifdef GENERIC_EPS_CFG_DEBUG
         OS_printf("  GENERIC_EPS_RequestHK read: ");
-        for(uint8_t i; i < GENERIC_EPS_DEVICE_HK_LEN+1; i++)
+        for(uint16_t i = 0; i < GENERIC_EPS_DEVICE_HK_LEN+1; i++)
         {
             OS_printf("0x%02x ",read_data[i]);
         }
@@ -152,7 +126,7 @@ int32_t GENERIC_EPS_CommandSwitch(i2c_bus_info_t* device, uint8_t switch_num, ui
     int32_t status = OS_SUCCESS;
 
     /* Check switch number valid */
-    if (switch_num < 8)
+    if (switch_num < GENERIC_EPS_CFG_NUM_SWITCHES)
     {
         /* Check value valid */
         if ((value == 0x00) || (value == 0xAA))
@@ -167,11 +141,11 @@ int32_t GENERIC_EPS_CommandSwitch(i2c_bus_info_t* device, uint8_t switch_num, ui
                 /* Confirm switch state changed in HK */
                 if (status == OS_SUCCESS)
                 {
-                    if ((data->Switch[switch_num].Status & 0x00FF) != value)
+                    if (GENERIC_EPS_SWITCH_IS_ON(data, switch_num) != (value == 0xAA))
                     {
                         status = OS_ERROR;
                         #ifdef GENERIC_EPS_CFG_DEBUG
-                            OS_printf("  GENERIC_EPS_CommandSwitch: HK reported incorrect switch state after command! (0x%02x expected, 0x%02x actual) \n", value, (data->Switch[switch_num].Status & 0x00FF));
+                            OS_printf("  GENERIC_EPS_CommandSwitch: HK reported incorrect switch state after command! (%s expected, %s actual) \n", (value == 0xAA) ? "on" : "off", GENERIC_EPS_SWITCH_IS_ON(data, switch_num) ? "on" : "off");
                         #endif 
                     }
                 }
@@ -189,7 +163,7 @@ int32_t GENERIC_EPS_CommandSwitch(i2c_bus_info_t* device, uint8_t switch_num, ui
     {
         status = OS_ERROR;
         #ifdef GENERIC_EPS_CFG_DEBUG
-            OS_printf("  GENERIC_EPS_CommandSwitch: Switch number of %d is invalid! (>= 8 expected) \n", switch_num);
+            OS_printf("  GENERIC_EPS_CommandSwitch: Switch number of %d is invalid! (< %d expected) \n", switch_num, GENERIC_EPS_CFG_NUM_SWITCHES);
         #endif 
     }
     return status;
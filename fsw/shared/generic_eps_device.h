@@ -11,9 +11,33 @@
 /*
 ** Required header files.
 */
+#include <string.h>
 #include "device_cfg.h"
 #include "hwlib.h"
 #include "generic_eps_platform_cfg.h"
+#include "generic_eps_crc.h"
+
+/*
+** Switch numbers are command codes, so they must stay below the 0x70 telemetry request
+*/
+#ifndef GENERIC_EPS_CFG_NUM_SWITCHES
+    #define GENERIC_EPS_CFG_NUM_SWITCHES 8
+#endif
+
+/*
+** One on/off bit per switch, switch n is bit (n % 8) of byte (n / 8)
+*/
+#define GENERIC_EPS_SWITCH_MASK_LEN ((GENERIC_EPS_CFG_NUM_SWITCHES + 7) / 8)
+#define GENERIC_EPS_SWITCH_IS_ON(hk, n) (((hk)->SwitchMask[(n) / 8] >> ((n) % 8)) & 0x01)
+
+/*
+** HK frame is read in one transaction, the hwlib read length is a single byte
+*/
+#define GENERIC_EPS_DEVICE_HK_FRAME_LEN (16 + GENERIC_EPS_SWITCH_MASK_LEN + 4 * GENERIC_EPS_CFG_NUM_SWITCHES + 1)
+#if (GENERIC_EPS_CFG_NUM_SWITCHES < 1) || (GENERIC_EPS_DEVICE_HK_FRAME_LEN > 255)
+    #error "GENERIC_EPS_CFG_NUM_SWITCHES must be between 1 and 57"
+#endif
+
 
 /*
 ** GENERIC_EPS device switch telemetry definition
@@ -22,7 +46,6 @@ typedef struct
 {
     uint16_t Voltage;
     uint16_t Current;
-    uint16_t Status;
 
 } __attribute__((packed)) GENERIC_EPS_Switch_tlm_t;
 
@@ -40,7 +63,8 @@ typedef struct
     uint16_t  EPSTemperature;
     uint16_t  SolarArrayVoltage;
     uint16_t  SolarArrayTemperature;
-    GENERIC_EPS_Switch_tlm_t  Switch[8];
+    uint8_t   SwitchMask[GENERIC_EPS_SWITCH_MASK_LEN];
+    GENERIC_EPS_Switch_tlm_t  Switch[GENERIC_EPS_CFG_NUM_SWITCHES];
 
 } __attribute__((packed)) GENERIC_EPS_Device_HK_tlm_t;
 #define GENERIC_EPS_DEVICE_HK_LEN sizeof ( GENERIC_EPS_Device_HK_tlm_t )
@@ -49,7 +73,6 @@ typedef struct
 /*
 ** Prototypes
 */
-uint8_t GENERIC_EPS_CRC8(uint8_t* payload, uint32_t length);
 int32_t GENERIC_EPS_CommandDevice(i2c_bus_info_t* device, uint8_t reg, uint8_t value);
 int32_t GENERIC_EPS_RequestHK(i2c_bus_info_t* device, GENERIC_EPS_Device_HK_tlm_t* data);
 int32_t GENERIC_EPS_CommandSwitch(i2c_bus_info_t* device, uint8_t switch_num, uint8_t value, GENERIC_EPS_Device_HK_tlm_t* data);
@@ -9,6 +9,9 @@
 #define GENERIC_EPS_CFG_I2C_SPEED        1000
 #define GENERIC_EPS_CFG_I2C_ADDRESS      0x2B // 7-bit address
 #define GENERIC_EPS_CFG_I2C_TIMEOUT      10
-#define GENERIC_EPS_CFG_DEBUG
+#define GENERIC_EPS_CFG_NUM_SWITCHES     8  // Must match physical.switch-count of the simulator
+#ifndef GENERIC_EPS_CHECKOUT_QUIET // Set for timing runs, debug prints every HK byte
+    #define GENERIC_EPS_CFG_DEBUG
+#endif
 
 #endif /* _GENERIC_EPS_CHECKOUT_DEVICE_CFG_H_ */
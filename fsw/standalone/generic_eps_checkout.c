@@ -30,9 +30,10 @@ void print_help(void)
         "exit                               - Exit app                        \n"
         "hk                                 - Request device housekeeping     \n"
         "  h                                - ^                               \n"
-        "switch # #                         - Switch [0-7] [0x00 off, 0xAA on]\n"
+        "switch # #                         - Switch [0-%d] [0x00 off, 0xAA on]\n"
         "  s # #                            - ^                               \n"
-        "\n"
+        "\n",
+        GENERIC_EPS_CFG_NUM_SWITCHES - 1
     );
 }
 
@@ -114,7 +115,7 @@ int process_command(int cc, int num_tokens, char tokens[MAX_INPUT_TOKENS][MAX_IN
                 switch_num = atoi(tokens[0]);
                 value = strtol(tokens[1], NULL, 16);
                 /* Check switch number valid */
-                if (switch_num < 8)
+                if (switch_num < GENERIC_EPS_CFG_NUM_SWITCHES)
                 {
                     /* Check value valid */
                     if ((value == 0x00) || (value == 0xAA))
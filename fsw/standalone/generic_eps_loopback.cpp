@@ -0,0 +1,151 @@
+/*******************************************************************************
+** File: generic_eps_loopback.cpp
+**
+** Purpose:
+**   hwlib I2C functions that call the GENERIC_EPS simulator model directly.
+**   Writes go through determine_i2c_response_for_request, reads return the
+**   response the same way the simulator I2C slave does.
+**
+*******************************************************************************/
+
+/*
+** Include Files
+*/
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include <boost/foreach.hpp>
+
+/* hwlib is C, the functions defined below must keep C linkage */
+extern "C" {
+#include "hwlib.h"
+}
+#include "generic_eps_loopback.h"
+
+#include <generic_eps_batch.hpp>
+#include <generic_eps_core.hpp>
+
+namespace Nos3
+{
+    /* The simulator logger is not set up here, debug output is gated off when the core is made */
+    ItcLogger::Logger *sim_logger = NULL;
+}
+
+
+/*
+** Global Variables
+*/
+static std::unique_ptr<Nos3::Generic_epsCore> Generic_epsLoopbackCore;
+static uint8_t  Generic_epsLoopbackAddr = 0x2B;
+static uint64_t Generic_epsLoopbackTime = 0;
+
+
+int32_t GENERIC_EPS_LoopbackInit(const char* config_file)
+{
+    boost::property_tree::ptree config;
+
+    if ((config_file != NULL) && (config_file[0] != '\0') && !Nos3::Generic_epsBatch::load_config(config_file, config))
+    {
+        return OS_ERROR;
+    }
+
+    /* Answer on the same address as the simulator would */
+    Generic_epsLoopbackAddr = 0x2B;
+    if (config.get_child_optional("simulator.hardware-model.connections"))
+    {
+        BOOST_FOREACH(const boost::property_tree::ptree::value_type &v, config.get_child("simulator.hardware-model.connections"))
+        {
+            if (v.second.get("type", "").compare("i2c") == 0)
+            {
+                Generic_epsLoopbackAddr = v.second.get("bus-address", Generic_epsLoopbackAddr);
+                break;
+            }
+        }
+    }
+
+    /* There is no logger behind sim_logger, gate everything before it */
+    Nos3::Generic_epsSimLog::set_level(GENERIC_EPS_SIM_LOG_OFF);
+
+    /* No other simulators to power, switch changes are only applied to the model */
+    Generic_epsLoopbackCore.reset(new Nos3::Generic_epsCore(config, 0.0, config.get("common.sim-microseconds-per-tick", 10000),
+        [](std::uint8_t, bool) {}));
+    Generic_epsLoopbackTime = 0;
+    return OS_SUCCESS;
+}
+
+
+void GENERIC_EPS_LoopbackAdvance(uint32_t ticks, double sun_x, double sun_y, double sun_z)
+{
+    Nos3::Generic_epsSunVector sun = {sun_x, sun_y, sun_z, true};
+    uint32_t i;
+
+    if (!Generic_epsLoopbackCore)
+    {
+        return;
+    }
+    for (i = 0; i < ticks; i++)
+    {
+        Generic_epsLoopbackCore->tick(sun, ++Generic_epsLoopbackTime);
+    }
+}
+
+
+void GENERIC_EPS_LoopbackClose(void)
+{
+    Generic_epsLoopbackCore.reset();
+}
+
+
+/*
+** hwlib I2C interface
+*/
+int32_t i2c_master_init(i2c_bus_info_t* device)
+{
+    if (!Generic_epsLoopbackCore && (GENERIC_EPS_LoopbackInit(getenv(GENERIC_EPS_LOOPBACK_CONFIG_ENV)) != OS_SUCCESS))
+    {
+        return OS_ERROR;
+    }
+    device->isOpen = I2C_OPEN;
+    return OS_SUCCESS;
+}
+
+
+int32_t i2c_master_transaction(i2c_bus_info_t* device, uint8_t addr, void* txbuf, uint8_t txlen, void* rxbuf, uint8_t rxlen, uint16_t timeout)
+{
+    static Nos3::Generic_epsI2CResponse out_data;
+    static std::size_t out_len = 0;
+    static uint8_t valid = GENERIC_EPS_SIM_ERROR;
+    std::size_t num_read;
+
+    (void) timeout;
+    if ((device->isOpen != I2C_OPEN) || !Generic_epsLoopbackCore || (addr != Generic_epsLoopbackAddr))
+    {
+        return OS_ERROR;
+    }
+
+    /* Write phase, the response is held for the reads that follow like the simulator I2C slave */
+    if (txlen > 0)
+    {
+        valid = Generic_epsLoopbackCore->determine_i2c_response_for_request((const uint8_t*) txbuf, txlen, out_data, out_len);
+
+        /* Ticks only come from GENERIC_EPS_LoopbackAdvance, apply switch and reset requests as this thread is the writer too */
+        Generic_epsLoopbackCore->apply_queued();
+    }
+
+    /* Read phase, invalid requests and bytes past the response read back as zeros */
+    if (rxlen > 0)
+    {
+        num_read = (valid == GENERIC_EPS_SIM_SUCCESS) ? ((rxlen < out_len) ? rxlen : out_len) : 0;
+        memcpy(rxbuf, out_data.data(), num_read);
+        memset((uint8_t*) rxbuf + num_read, 0, rxlen - num_read);
+    }
+    return OS_SUCCESS;
+}
+
+
+int32_t i2c_master_close(i2c_bus_info_t* device)
+{
+    device->isOpen = I2C_CLOSED;
+    return OS_SUCCESS;
+}
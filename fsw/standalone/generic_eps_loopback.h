@@ -0,0 +1,45 @@
+/*******************************************************************************
+** File: generic_eps_loopback.h
+**
+** Purpose:
+**   In-process hwlib I2C backend that answers GENERIC_EPS transactions with the
+**   simulator model, so device code and simulator run in one binary without
+**   NOS Engine.  Link generic_eps_loopback.cpp in place of a hwlib libi2c.c.
+**
+*******************************************************************************/
+#ifndef _GENERIC_EPS_LOOPBACK_H_
+#define _GENERIC_EPS_LOOPBACK_H_
+
+/*
+** Required header files.
+*/
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+** Defines
+*/
+#define GENERIC_EPS_LOOPBACK_CONFIG_ENV "GENERIC_EPS_LOOPBACK_CONFIG" /* Simulator config read by i2c_master_init */
+
+
+/*
+** Prototypes
+*/
+
+/* Build the model from a simulator config, NULL for the model defaults; i2c_master_init does this on first use */
+int32_t GENERIC_EPS_LoopbackInit(const char* config_file);
+
+/* Simulator time stands still between calls, run ticks time ticks with the given sun vector */
+void GENERIC_EPS_LoopbackAdvance(uint32_t ticks, double sun_x, double sun_y, double sun_z);
+
+/* Release the model */
+void GENERIC_EPS_LoopbackClose(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _GENERIC_EPS_LOOPBACK_H_ */
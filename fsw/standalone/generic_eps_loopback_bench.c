@@ -0,0 +1,126 @@
+/*******************************************************************************
+** File: generic_eps_loopback_bench.c
+**
+** Purpose:
+**   Runs the GENERIC_EPS device functions against the simulator model over the
+**   in-process loopback I2C backend.  Checks every HK frame and every switch
+**   command and reports the transaction rate.
+**   Exits non-zero if any transaction fails.
+**
+**   Usage: generic_eps_loopback_bench [hk transactions] [simulator config]
+**
+*******************************************************************************/
+
+/*
+** Include Files
+*/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "generic_eps_device.h"
+#include "generic_eps_loopback.h"
+
+
+/*
+** Standard Defines
+*/
+#define BENCH_HK_DEFAULT        1000000
+#define BENCH_TICKS_PER_HK      1       /* Sim time moves on between HK requests like a running simulator */
+#define BENCH_SWITCH_CYCLES     1000
+
+
+i2c_bus_info_t Generic_epsI2C;
+GENERIC_EPS_Device_HK_tlm_t Generic_epsHK;
+
+
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec * 1e9 + (double) ts.tv_nsec;
+}
+
+
+int main(int argc, char *argv[])
+{
+    uint32_t hk_count = BENCH_HK_DEFAULT;
+    uint32_t errors = 0;
+    uint32_t i;
+    uint8_t sw;
+    uint16_t first_voltage;
+    double start;
+    double elapsed;
+
+    if (argc > 1)
+    {
+        hk_count = (uint32_t) strtoul(argv[1], NULL, 10);
+    }
+    if (GENERIC_EPS_LoopbackInit((argc > 2) ? argv[2] : NULL) != OS_SUCCESS)
+    {
+        printf("Unable to load simulator config %s\n", argv[2]);
+        return 1;
+    }
+
+    Generic_epsI2C.handle = GENERIC_EPS_CFG_I2C_HANDLE;
+    Generic_epsI2C.addr = GENERIC_EPS_CFG_I2C_ADDRESS;
+    Generic_epsI2C.isOpen = I2C_CLOSED;
+    Generic_epsI2C.speed = GENERIC_EPS_CFG_I2C_SPEED;
+    if (i2c_master_init(&Generic_epsI2C) != OS_SUCCESS)
+    {
+        printf("I2C device 0x%02x failed to initialize!\n", Generic_epsI2C.addr);
+        return 1;
+    }
+
+    /* Every frame must pass its CRC */
+    if (GENERIC_EPS_RequestHK(&Generic_epsI2C, &Generic_epsHK) != OS_SUCCESS)
+    {
+        errors++;
+    }
+    first_voltage = Generic_epsHK.BatteryVoltage;
+
+    start = now_ns();
+    for (i = 0; i < hk_count; i++)
+    {
+        GENERIC_EPS_LoopbackAdvance(BENCH_TICKS_PER_HK, 1.0, 0.0, 0.0);
+        if (GENERIC_EPS_RequestHK(&Generic_epsI2C, &Generic_epsHK) != OS_SUCCESS)
+        {
+            errors++;
+        }
+    }
+    elapsed = now_ns() - start;
+    printf("hk,%u,%.1f ns/transaction,%.0f transactions/s,battery 0x%04x -> 0x%04x\n",
+        hk_count, elapsed / hk_count, hk_count * 1e9 / elapsed, first_voltage, Generic_epsHK.BatteryVoltage);
+
+    /* Each switch on then off, GENERIC_EPS_CommandSwitch reads HK back to confirm the state */
+    start = now_ns();
+    for (i = 0; i < BENCH_SWITCH_CYCLES; i++)
+    {
+        for (sw = 0; sw < GENERIC_EPS_CFG_NUM_SWITCHES; sw++)
+        {
+            if (GENERIC_EPS_CommandSwitch(&Generic_epsI2C, sw, 0xAA, &Generic_epsHK) != OS_SUCCESS)
+            {
+                errors++;
+            }
+            if (GENERIC_EPS_CommandSwitch(&Generic_epsI2C, sw, 0x00, &Generic_epsHK) != OS_SUCCESS)
+            {
+                errors++;
+            }
+        }
+    }
+    elapsed = now_ns() - start;
+    printf("switch,%u,%.1f ns/command with readback\n",
+        BENCH_SWITCH_CYCLES * 2 * GENERIC_EPS_CFG_NUM_SWITCHES, elapsed / (BENCH_SWITCH_CYCLES * 2 * GENERIC_EPS_CFG_NUM_SWITCHES));
+
+    i2c_master_close(&Generic_epsI2C);
+    GENERIC_EPS_LoopbackClose();
+
+    if (errors != 0)
+    {
+        printf("%u transactions FAILED\n", errors);
+        return 1;
+    }
+    printf("All transactions passed\n");
+    return 0;
+}
@@ -1,15 +1,19 @@
 #ifndef NOS3_GENERIC_EPS42DATAPROVIDER_HPP
 #define NOS3_GENERIC_EPS42DATAPROVIDER_HPP
 
+#include <atomic>
+#include <mutex>
+
 #include <boost/property_tree/ptree.hpp>
 #include <ItcLogger/Logger.hpp>
 #include <generic_eps_data_point.hpp>
+#include <generic_eps_sim_log.hpp>
 #include <sim_data_42socket_provider.hpp>
 
 namespace Nos3
 {
     /* Standard for a 42 data provider */
-    class Generic_eps42DataProvider : public SimData42SocketProvider
+    class Generic_eps42DataProvider : public SimData42SocketProvider, public Generic_epsSunVectorSource
     {
     public:
         /* Constructors */
@@ -17,13 +21,27 @@ namespace Nos3
 
         /* Accessors */
         boost::shared_ptr<SimIDataPoint> get_data_point(void) const;
+        Generic_epsSunVector get_sun_vector(void) const;
+        std::uint64_t get_cache_hits(void) const {return _cache_hits.load(std::memory_order_relaxed);}
+        std::uint64_t get_cache_misses(void) const {return _cache_misses.load(std::memory_order_relaxed);}
 
     private:
         /* Disallow these */
         ~Generic_eps42DataProvider(void) {};
         Generic_eps42DataProvider& operator=(const Generic_eps42DataProvider&) {return *this;};
 
+        void refresh_cache(void) const; /* Re-parse if the socket provider has a new 42 frame, cache lock held */
+
         int16_t _sc;  /* Which spacecraft number to parse out of 42 data */
+        std::string _svb_prefix; /* 42 line prefix for this spacecraft's sun vector */
+
+        /* Parsed sample for the last 42 frame, re-parsed only when a new frame arrives */
+        mutable std::mutex                       _cache_mutex;
+        mutable boost::shared_ptr<Sim42DataPoint> _cache_frame;
+        mutable Generic_epsSunVector             _cache_sun;
+        mutable boost::shared_ptr<SimIDataPoint>  _cache_point; /* Built on demand for get_data_point */
+        mutable std::atomic<std::uint64_t>       _cache_hits;
+        mutable std::atomic<std::uint64_t>       _cache_misses;
     };
 }
 
@@ -0,0 +1,81 @@
+#ifndef NOS3_GENERIC_EPSBACKDOOR_HPP
+#define NOS3_GENERIC_EPSBACKDOOR_HPP
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Nos3
+{
+    /* One parameter reachable through SET and GET, values are in the units of the simulator configuration */
+    struct Generic_epsBackdoorParam
+    {
+        enum Target {BUS, SWITCH, SUN, ENABLED, TIME, POWER, READY, RESETS};
+        enum Field {VOLTAGE, CURRENT, TEMPERATURE, STATUS, STATE, WATTHRS, X, Y, Z, OVERRIDE, VALUE, P_IN, P_OUT};
+
+        std::string   name;
+        Target        target;
+        Field         field;
+        std::uint8_t  index;     /* Bus or switch number */
+        bool          writable;
+        double        min;       /* Accepted SET range */
+        double        max;
+    };
+
+    /* A parsed command, operations run in the order given */
+    struct Generic_epsBackdoorRequest
+    {
+        struct Op
+        {
+            const Generic_epsBackdoorParam* param;
+            bool                            set;
+            double                          value;
+        };
+
+        std::vector<Op> ops;
+    };
+
+    /*
+    ** Batched backdoor grammar, statements separated by ';':
+    **     SET <key>=<value> [<key>=<value> ...]
+    **     GET <key or pattern> [...]
+    ** Patterns may use '*', for example GET switch.* or GET *.current
+    ** Keys are looked up in a hash table built once for the switch count, the whole command is parsed and
+    ** range checked before anything is applied, so a bad key or value leaves the model untouched
+    */
+    class Generic_epsBackdoor
+    {
+    public:
+        explicit Generic_epsBackdoor(std::uint8_t num_switches);
+
+        /* True if the command starts with SET or GET, in any case */
+        static bool is_request(const std::string& command);
+
+        /* Returns false with a message in error if any statement is invalid */
+        bool parse(const std::string& command, Generic_epsBackdoorRequest& request, std::string& error) const;
+
+        const std::vector<Generic_epsBackdoorParam>& get_params(void) const {return _params;}
+
+        /* Append key=value in the reply format */
+        static void format(const Generic_epsBackdoorParam& param, double value, std::string& reply);
+
+        /* True if value is within the key's range and, for rail fields, still fits 16 bits once rounded */
+        static bool in_range(const Generic_epsBackdoorParam& param, double value);
+
+        /* Rail fields are held as 16 bit words of mV, mA, (C + 60) * 100 or the raw status, clamped rather than wrapped */
+        static std::uint16_t to_word(Generic_epsBackdoorParam::Field field, double value);
+
+    private:
+        void add(const std::string& name, Generic_epsBackdoorParam::Target target, Generic_epsBackdoorParam::Field field,
+            std::uint8_t index, bool writable, double min, double max);
+        static bool match(const char* pattern, const char* name);
+        static bool parse_value(const std::string& text, double& value);
+
+        /* Parameters in listing order, the table maps each key to its position */
+        std::vector<Generic_epsBackdoorParam>               _params;
+        std::unordered_map<std::string, std::size_t>        _table;
+    };
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef NOS3_GENERIC_EPSBATCH_HPP
+#define NOS3_GENERIC_EPSBATCH_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <generic_eps_power_model.hpp>
+#include <generic_eps_trace.hpp>
+
+namespace Nos3
+{
+    /* Switch or sun change applied before the tick it falls on */
+    struct Generic_epsBatchEvent
+    {
+        std::uint64_t           tick;
+        bool                    is_switch;
+        std::uint8_t            sw_num;
+        std::uint16_t           sw_status;
+        Generic_epsSunVector    sun;
+    };
+
+    /* Battery summary of one run */
+    struct Generic_epsBatchResult
+    {
+        double  min_watthrs;
+        double  min_time;       /* Seconds */
+        double  below_time;     /* Seconds spent under the threshold */
+        double  final_watthrs;
+    };
+
+    /*
+    ** Steps power models through a schedule with no NOS Engine, shared by the batch tools
+    ** The schedule is read only while running, so one instance can drive models on many threads
+    ** Event integration jumps from one schedule event or record to the next in closed form,
+    ** tick integration steps every tick, both give identical results
+    */
+    class Generic_epsBatch
+    {
+    public:
+        Generic_epsBatch(std::int64_t tick_us, double duration, bool event_integration = true);
+
+        /* Read a simulator block or a full nos3-simulator.xml into the layout the hardware model sees, errors go to stderr */
+        static bool load_config(const std::string& filename, boost::property_tree::ptree& config);
+
+        /* Lines are "<seconds> SWITCH <n> <hex status>" or "<seconds> SUN <x> <y> <z>", errors go to stderr */
+        bool load_schedule(const std::string& filename);
+
+        /* Run to the end, recording every n-th tick into recs when given */
+        Generic_epsBatchResult run(Generic_epsPowerModel& power, double threshold_watthrs,
+            std::uint64_t every = 0, std::vector<Generic_epsTraceRecord>* recs = nullptr) const;
+
+        std::int64_t  get_tick_us(void) const {return _tick_us;}
+        std::uint64_t get_ticks(void) const {return _ticks;}
+
+    private:
+        /* Ticks among the next ticks steps of delta_pwh from start_pwh that end below threshold_pwh */
+        static std::uint64_t ticks_below(std::int64_t start_pwh, std::int64_t delta_pwh, std::uint64_t ticks, std::int64_t threshold_pwh);
+
+        std::int64_t                        _tick_us;
+        std::uint64_t                       _ticks;
+        bool                                _event_integration;
+        std::vector<Generic_epsBatchEvent>  _events;
+    };
+}
+
+#endif
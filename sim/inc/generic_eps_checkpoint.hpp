@@ -0,0 +1,57 @@
+#ifndef NOS3_GENERIC_EPSCHECKPOINT_HPP
+#define NOS3_GENERIC_EPSCHECKPOINT_HPP
+
+#include <cstdint>
+#include <string>
+
+#include <generic_eps_power_model.hpp>
+
+/*
+** Checkpoint file layout: one Generic_epsCheckpointHeader followed by the bus rails, then the switch rails
+*/
+#define GENERIC_EPS_CHECKPOINT_MAGIC    "EPSSTATE"
+#define GENERIC_EPS_CHECKPOINT_VERSION  1
+
+namespace Nos3
+{
+    struct Generic_epsCheckpointHeader
+    {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t rail_size;
+        std::uint8_t  num_buses;
+        std::uint8_t  num_switches;
+        std::uint8_t  enabled;
+        std::uint8_t  initialized_other_sims;
+        std::uint32_t spare;
+        std::int64_t  battery_pwh;
+        double        p_in;
+    };
+
+    /*
+    ** Power model state plus the hardware model flags, saved and restored as a whole
+    ** Capture and apply only copy memory so they can run under the state lock, file access happens outside it
+    ** Configuration such as battery capacity and panel power is not saved, a checkpoint can be applied under a different one
+    */
+    class Generic_epsCheckpoint
+    {
+    public:
+        void capture(const Generic_epsPowerModel& power, std::uint8_t enabled, std::uint8_t initialized_other_sims);
+
+        /* False if the switch count differs from the model's, nothing is changed then */
+        bool apply(Generic_epsPowerModel& power, std::uint8_t& enabled, std::uint8_t& initialized_other_sims) const;
+
+        /* Returns false on error */
+        bool write(const std::string& filename) const;
+
+        /* Returns false if the file is not a valid checkpoint */
+        bool read(const std::string& filename);
+
+    private:
+        Generic_epsCheckpointHeader         _hdr;
+        Generic_epsPowerModel::EPS_Rail     _bus[GENERIC_EPS_POWER_NUM_BUSES];
+        Generic_epsPowerModel::EPS_Rail     _switch[GENERIC_EPS_POWER_MAX_SWITCHES];
+    };
+}
+
+#endif
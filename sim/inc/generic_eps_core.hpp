@@ -0,0 +1,187 @@
+#ifndef NOS3_GENERIC_EPSCORE_HPP
+#define NOS3_GENERIC_EPSCORE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <generic_eps_power_model.hpp>
+#include <generic_eps_core_fleet.hpp>
+#include <generic_eps_hk_frame.hpp>
+#include <generic_eps_checkpoint.hpp>
+#include <generic_eps_sim_log.hpp>
+#include <generic_eps_trace.hpp>
+#include <generic_eps_seqlock.hpp>
+#include <generic_eps_backdoor.hpp>
+#include <generic_eps_crc.h>
+
+#define GENERIC_EPS_SIM_SUCCESS 0
+#define GENERIC_EPS_SIM_ERROR   1
+
+#define GENERIC_EPS_SIM_HEX_STR_LEN  (3 * GENERIC_EPS_SIM_HK_FRAME_MAX_LEN + 1)
+#define GENERIC_EPS_SIM_I2C_QUEUE    64  /* Switch and reset requests waiting for the writer, more are refused */
+
+namespace Nos3
+{
+    /* Fixed capacity I2C response, large enough for the HK frame of any switch count */
+    typedef std::array<std::uint8_t, GENERIC_EPS_SIM_HK_FRAME_MAX_LEN> Generic_epsI2CResponse;
+
+    /*
+    ** One EPS as seen on its I2C address: power model, HK frame and command handling with no NOS Engine dependency
+    ** The hardware model feeds it time ticks and I2C requests, replay and test tools drive it directly
+    ** Its rails, switches and battery are a slot in a Generic_epsCoreFleet, shared with the other instances of a
+    ** multi model or its own otherwise.  Ticks and I2C requests may come from different threads, I2C requests from
+    ** one at a time.  The I2C thread never writes the state: switch and reset requests are queued for the fleet's
+    ** writer, the next tick or command, and HK requested before then is encoded with them applied to a copy.
+    */
+    class Generic_epsCore
+    {
+    public:
+        /* Called outside the state lock when a switch must be turned on or off in another simulator */
+        typedef std::function<void(std::uint8_t sw_num, bool on)> SwitchNotify;
+
+        /* In a fleet of its own, or in slot of fleet, which then sets the tick length and must outlive the core */
+        Generic_epsCore(const boost::property_tree::ptree& config, double absolute_start_time, std::int64_t microseconds_per_tick, SwitchNotify notify,
+            Generic_epsCoreFleet* fleet = nullptr);
+
+        std::uint8_t determine_i2c_response_for_request(const std::uint8_t* in_data, std::size_t in_len, Generic_epsI2CResponse& out_data, std::size_t& out_len);
+
+        /*
+        ** Time tick number time with the sun at that tick, the first one also powers the simulators on switches that start on
+        ** Only for a core in a fleet of its own, a shared fleet is ticked as a whole with Generic_epsCoreFleet::tick
+        */
+        void tick(const Generic_epsSunVector& sun, std::uint64_t time) {_fleet.tick(&sun, time);}
+
+        /* Device reset, back to the configured rails, switches and battery */
+        void reset(void);
+
+        /* Apply the queued I2C switch and reset requests of the fleet now, for drivers with no tick between requests */
+        void apply_queued(void) {_fleet.apply_queued();}
+
+        /* From any thread, I2C requests see the change with their next request */
+        void set_enabled(bool enabled) {_enabled.store(enabled ? GENERIC_EPS_SIM_SUCCESS : GENERIC_EPS_SIM_ERROR, std::memory_order_relaxed);}
+        bool save_checkpoint(const std::string& filename);
+        bool load_checkpoint(const std::string& filename);
+        bool apply_checkpoint(const Generic_epsCheckpoint& checkpoint);
+
+        /* Run a parsed SET/GET command under one state lock, returns "OK" followed by key=value for each GET */
+        std::string execute(const Generic_epsBackdoorRequest& request);
+
+        /* Sun to tick with, the backdoor sun while sun.override is set and otherwise the data provider's */
+        Generic_epsSunVector get_sun(const Generic_epsSunVector& provided) const;
+
+        /* True once the first tick has powered the simulators on switches that start on */
+        bool get_ready(void) const;
+
+        /* Write the power model trace, returns the number of records written or -1 on error */
+        std::int64_t dump_trace(const std::string& filename) const {return _trace->dump(filename);}
+
+        /* Copy of the rails, switches and battery, consistent from any thread */
+        Generic_epsPowerModel get_power(void) const;
+
+        std::uint8_t  get_num_switches(void) const {return _initial_power.get_num_switches();}
+        std::uint16_t get_frame_len(void) const {return _hk.get_frame_len();}
+        std::uint64_t get_time(void) const {return _time.load(std::memory_order_relaxed);}
+        std::uint64_t get_resets(void) const {return _resets.load(std::memory_order_relaxed);}
+        Generic_epsWriterStats get_writer_stats(void) const;
+        bool          get_event_integration(void) const {return _event_integration;}
+        double        get_sun_tolerance(void) const {return _sun_tolerance;}
+
+        /* Size, CRC and switch state checks shared by every EPS model */
+        static std::uint8_t check_i2c_request(const std::uint8_t* in_data, std::size_t in_len, std::uint8_t num_switches);
+
+        /* Format bytes as hex into a caller provided buffer, truncating to fit */
+        static const char* uint8_array_to_hex_string(const std::uint8_t* data, std::size_t len, char* str, std::size_t str_len);
+
+    private:
+        friend class Generic_epsCoreFleet;
+
+        /* Disallow these */
+        Generic_epsCore(const Generic_epsCore&);
+        Generic_epsCore& operator=(const Generic_epsCore&);
+
+        /* Fleet tick, state lock held: the ticks and sun to step this slot by, and after the step the trace and frame */
+        std::uint64_t begin_tick(const Generic_epsSunVector& sun, std::uint64_t time, Generic_epsSunVector& step_sun, std::uint64_t& step_ticks);
+        void end_step(bool changed);
+
+        /* I2C thread: queue a switch or reset request for the writer, and the HK frame with the queued ones applied */
+        std::uint8_t queue_i2c_request(std::uint8_t cmd, std::uint8_t data);
+        void copy_hk(std::uint8_t* out_data);
+
+        /* Writer: apply the queued requests with the state lock held, returns the switches they changed */
+        bool has_queued(void) const {return _i2c_head.load(std::memory_order_acquire) != _i2c_tail.load(std::memory_order_relaxed);}
+        std::uint64_t take_queued(void);
+        void notify_switched(std::uint64_t changed) {notify_changed(changed, _power.get_switch_mask(_slot), _initialized_other_sims == GENERIC_EPS_SIM_SUCCESS);}
+
+        void notify_changed(std::uint64_t changed, std::uint64_t mask, bool initialized); /* State lock not held, arguments read under it */
+        void publish_generic_eps_data(void); /* Encode the HK frame into the back buffer and swap it in, state lock held */
+        void integrate_battery_values(void); /* Apply the pending ticks, state lock held */
+        Generic_epsPowerModel get_model(void) const; /* The slot as a model of its own, state lock held or read section */
+        void set_switch_status(std::uint8_t sw_num, std::uint16_t sw_status); /* State lock held */
+        double get_param(const Generic_epsBackdoorParam& param) const; /* State lock held */
+        void set_param(const Generic_epsBackdoorParam& param, double value); /* State lock held */
+
+        /* Rails, switches and battery are slot _slot of the fleet's power, written by the fleet's writer under its state lock */
+        std::unique_ptr<Generic_epsCoreFleet>               _own_fleet;
+        Generic_epsCoreFleet&                               _fleet;
+        Generic_epsPowerFleet&                              _power;
+        Generic_epsSeqlock&                                 _state_lock;
+
+        /* State as configured, copied back by a reset, and the model checkpoints and rail edits go through */
+        const Generic_epsPowerModel                         _initial_power;
+
+        /*
+        ** Switch and reset requests, written by the I2C thread up to _i2c_head and taken by the writer up to _i2c_tail,
+        ** which it moves inside its state lock write section.  Ahead of _slot, the writer may look at them once joined.
+        */
+        struct I2CRequest
+        {
+            std::uint8_t cmd;
+            std::uint8_t data;
+        };
+        std::array<I2CRequest, GENERIC_EPS_SIM_I2C_QUEUE>  _i2c_queue;
+        std::atomic<std::uint64_t>                          _i2c_head;
+        std::atomic<std::uint64_t>                          _i2c_tail;
+        std::atomic<std::uint64_t>                          _i2c_refused;
+
+        const std::size_t                                   _slot;
+
+        /* HK frame encoded on every state change, only copied out on the I2C path */
+        Generic_epsHkFrame                                  _hk;
+
+        /* I2C thread only: the state with the queued requests applied, for HK requested before the writer takes them */
+        Generic_epsPowerModel                               _i2c_power;
+        Generic_epsHkFrame                                  _i2c_hk;
+
+        /* Per tick power model trace */
+        std::unique_ptr<Generic_epsTrace>                   _trace;
+
+        SwitchNotify                                        _notify;
+
+        /* Time of the last tick */
+        double                                              _absolute_start_time;
+        std::atomic<std::uint64_t>                          _time;
+
+        /* Ticks run at _pending_sun but not yet applied, always zero with tick integration */
+        bool                                                _event_integration;
+        double                                              _sun_tolerance;
+        Generic_epsSunVector                                _pending_sun;
+        std::uint64_t                                       _pending_ticks;
+
+        /* Sun held by the backdoor, guarded by _state_lock */
+        bool                                                _sun_override;
+        Generic_epsSunVector                                _override_sun;
+
+        /* Set by commands on the command bus, read by I2C requests outside the state lock */
+        std::atomic<std::uint8_t>                           _enabled;
+        std::uint8_t                                        _initialized_other_sims;
+        std::atomic<std::uint64_t>                          _resets;
+    };
+}
+
+#endif
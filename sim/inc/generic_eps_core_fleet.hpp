@@ -0,0 +1,123 @@
+#ifndef NOS3_GENERIC_EPSCOREFLEET_HPP
+#define NOS3_GENERIC_EPSCOREFLEET_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <generic_eps_power_fleet.hpp>
+#include <generic_eps_seqlock.hpp>
+
+#define GENERIC_EPS_CORE_FLEET_DEFERRED_TICKS  8   /* Ticks handed to a command holding the writer role before the tick thread waits for it */
+
+namespace Nos3
+{
+    class Generic_epsCore;
+
+    /* Writer side counts */
+    struct Generic_epsWriterStats
+    {
+        std::uint64_t writes;      /* State lock write sections, wraps at 2^31 */
+        std::uint64_t handed_off;  /* Ticks that found a command writing and were run by it instead */
+        std::uint64_t queued;      /* I2C switch and reset requests queued for the writer, of one core */
+        std::uint64_t refused;     /* I2C requests refused because that core's queue was full */
+    };
+
+    /*
+    ** The rails, switches and battery of a set of cores, stepped together
+    ** Each Generic_epsCore indexes its slot in one power fleet, so a time tick for every core is a single pass over
+    ** the struct of arrays.  A core made on its own gets a fleet of one.  The state lock covers every slot.
+    **
+    ** The state has a single writer at a time, whoever holds the writer role: the tick thread for each tick, or a
+    ** backdoor command.  I2C callbacks never write or wait, they queue switch and reset requests on their core
+    ** for the next writer and only read.  A tick that finds a command writing is handed to it rather than waiting.
+    */
+    class Generic_epsCoreFleet
+    {
+    public:
+        explicit Generic_epsCoreFleet(std::int64_t microseconds_per_tick);
+
+        /* Room for cores, before the first is made, so slots in use never move while I2C requests arrive for them */
+        void reserve(std::size_t cores);
+
+        /* Time tick number time for every core, sun indexed in the order the cores were made, each core's backdoor sun is not applied here */
+        void tick(const Generic_epsSunVector* sun, std::uint64_t time);
+
+        /* Apply queued I2C requests now, for drivers with no tick between requests */
+        void apply_queued(void);
+
+        std::size_t   size(void) const {return _cores.size();}
+        double        get_seconds_per_tick(void) const {return _seconds_per_tick;}
+        std::uint64_t get_writes(void) const {return _state_lock.get_writes();}
+        std::uint64_t get_handed_off(void) const {return _handed_off.load(std::memory_order_relaxed);}
+
+        /* Scoped writer role and state lock write section for commands, runs whatever was queued for the writer first */
+        class Writer
+        {
+        public:
+            explicit Writer(Generic_epsCoreFleet& fleet) : _fleet(fleet) {_fleet.acquire(); _fleet.run_posted(); _fleet._state_lock.write_lock();}
+            ~Writer(void) {_fleet._state_lock.write_unlock(); _fleet.release();}
+
+        private:
+            Writer(const Writer&);
+            Writer& operator=(const Writer&);
+
+            Generic_epsCoreFleet& _fleet;
+        };
+
+    private:
+        friend class Generic_epsCore;
+
+        /* A tick handed to the writer role holder */
+        struct DeferredTick
+        {
+            std::uint64_t                      time;
+            std::vector<Generic_epsSunVector>  sun;
+        };
+
+        /* Disallow these */
+        Generic_epsCoreFleet(const Generic_epsCoreFleet&);
+        Generic_epsCoreFleet& operator=(const Generic_epsCoreFleet&);
+
+        /* Called by the core's constructor before any tick, returns its slot */
+        std::size_t join(Generic_epsCore* core, const Generic_epsPowerModel& model);
+
+        /* Called by a core's I2C thread after queueing a request */
+        void post(void) {_posted.fetch_add(1);}
+
+        void acquire(void);         /* Wait for the writer role, commands and tools only, never the I2C path */
+        void release(void);         /* Let go of the role, running anything posted while it was held */
+        void run_while_posted(void);
+        void run_posted(void);      /* Queued I2C requests and handed off ticks in order, writer role held */
+        void apply_i2c(void);       /* Every core's queued I2C requests, writer role held */
+        void run_tick(const Generic_epsSunVector* sun, std::uint64_t time); /* Writer role held */
+
+        double                                              _seconds_per_tick;
+
+        /* Every core's rails, switches and battery, written by the writer role holder under _state_lock */
+        Generic_epsPowerFleet                               _power;
+        Generic_epsSeqlock                                  _state_lock;
+        std::vector<Generic_epsCore*>                       _cores;
+
+        /* Writer role, and the count of requests and ticks posted for it against those it has run */
+        std::atomic<bool>                                   _writer;
+        std::atomic<std::uint64_t>                          _posted;
+        std::atomic<std::uint64_t>                          _consumed;
+
+        /* Ticks handed off, written by the tick thread and run by the role holder */
+        std::array<DeferredTick, GENERIC_EPS_CORE_FLEET_DEFERRED_TICKS> _deferred;
+        std::atomic<std::uint64_t>                          _deferred_head;
+        std::atomic<std::uint64_t>                          _deferred_tail;
+        std::atomic<std::uint64_t>                          _handed_off;
+
+        /* Writer scratch, indexed by slot */
+        std::vector<Generic_epsSunVector>                   _step_sun;
+        std::vector<std::uint64_t>                          _step_ticks;
+        std::vector<std::uint8_t>                           _changed;
+        std::vector<std::uint64_t>                          _power_on;
+        std::vector<std::uint64_t>                          _switched;
+    };
+}
+
+#endif
@@ -1,18 +1,51 @@
 #ifndef NOS3_GENERIC_EPSDATAPOINT_HPP
 #define NOS3_GENERIC_EPSDATAPOINT_HPP
 
+#include <vector>
+
 #include <boost/shared_ptr.hpp>
 #include <sim_42data_point.hpp>
+#include <generic_eps_sim_log.hpp>
+#include <generic_eps_power_model.hpp>
 
 namespace Nos3
 {
+    /* Typed access implemented by the EPS data providers alongside get_data_point */
+    class Generic_epsSunVectorSource
+    {
+    public:
+        virtual ~Generic_epsSunVectorSource(void) {}
+        virtual Generic_epsSunVector get_sun_vector(void) const = 0;
+    };
+
+    /* Sun vectors for several spacecraft out of one 42 frame, implemented by the multi spacecraft provider */
+    class Generic_epsSunVectorFleetSource
+    {
+    public:
+        virtual ~Generic_epsSunVectorFleetSource(void) {}
+        virtual void get_sun_vectors(const std::vector<std::int16_t>& spacecraft, std::vector<Generic_epsSunVector>& out) const = 0;
+    };
+
     /* Standard for a data point used transfer data between a data provider and a hardware model */
     class Generic_epsDataPoint : public SimIDataPoint
     {
     public:
         /* Constructors */
         Generic_epsDataPoint(double count);
-        Generic_epsDataPoint(int16_t spacecraft, const boost::shared_ptr<Sim42DataPoint> dp);
+        Generic_epsDataPoint(const std::string& svb_prefix, const boost::shared_ptr<Sim42DataPoint> dp);
+        Generic_epsDataPoint(const Generic_epsSunVector& sun);
+
+        /* Shared by the constructors and the typed provider path */
+        static Generic_epsSunVector sun_vector_from_count(double count);
+        static Generic_epsSunVector parse_sun_vector(const std::string& svb_prefix, const boost::shared_ptr<Sim42DataPoint>& dp);
+        static void parse_sun_vectors(const boost::shared_ptr<Sim42DataPoint>& dp, std::vector<Generic_epsSunVector>& by_spacecraft);
+
+        /* Same parsers on the lines of a 42 frame, in their own translation unit so tools can use them without sim_common */
+        static Generic_epsSunVector parse_sun_vector(const std::string& svb_prefix, const std::vector<std::string>& lines);
+        static void parse_sun_vectors(const std::vector<std::string>& lines, std::vector<Generic_epsSunVector>& by_spacecraft);
+
+        /* The TIME line of a 42 frame, empty if the frame has none */
+        static std::string frame_time(const std::vector<std::string>& lines);
 
         /* Accessors */
         /* Provide the hardware model a way to get the specific data out of the data point */
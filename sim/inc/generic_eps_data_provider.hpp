@@ -4,11 +4,12 @@
 #include <boost/property_tree/xml_parser.hpp>
 #include <ItcLogger/Logger.hpp>
 #include <generic_eps_data_point.hpp>
+#include <generic_eps_sim_log.hpp>
 #include <sim_i_data_provider.hpp>
 
 namespace Nos3
 {
-    class Generic_epsDataProvider : public SimIDataProvider
+    class Generic_epsDataProvider : public SimIDataProvider, public Generic_epsSunVectorSource
     {
     public:
         /* Constructors */
@@ -16,6 +17,7 @@ namespace Nos3
 
         /* Accessors */
         boost::shared_ptr<SimIDataPoint> get_data_point(void) const;
+        Generic_epsSunVector get_sun_vector(void) const;
 
     private:
         /* Disallow these */
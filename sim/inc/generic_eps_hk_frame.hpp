@@ -0,0 +1,82 @@
+#ifndef NOS3_GENERIC_EPSHKFRAME_HPP
+#define NOS3_GENERIC_EPSHKFRAME_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include <generic_eps_crc.h>
+#include <generic_eps_power_model.hpp>
+
+/*
+** HK frame for n switches: 16 bytes of rails, one on bit per switch (switch 0 in bit 0 of the first byte),
+** then voltage and current of each switch, then the CRC
+*/
+#define GENERIC_EPS_SIM_HK_HEADER_LEN       16
+#define GENERIC_EPS_SIM_HK_MASK_LEN(n)      (((n) + 7) / 8)
+#define GENERIC_EPS_SIM_HK_DATA_LEN(n)      (GENERIC_EPS_SIM_HK_HEADER_LEN + GENERIC_EPS_SIM_HK_MASK_LEN(n) + 4 * (n)) /* Telemetry payload, CRC follows */
+#define GENERIC_EPS_SIM_HK_FRAME_LEN(n)     (GENERIC_EPS_SIM_HK_DATA_LEN(n) + 1)
+#define GENERIC_EPS_SIM_HK_FRAME_MAX_LEN    GENERIC_EPS_SIM_HK_FRAME_LEN(GENERIC_EPS_POWER_MAX_SWITCHES)
+
+/* HK frame segments tracked for incremental encoding, one per rail, the switch mask, and the switches eight at a time */
+#define GENERIC_EPS_SIM_HK_SWITCH_GROUP     8
+#define GENERIC_EPS_SIM_HK_MAX_SEGMENTS     (6 + GENERIC_EPS_POWER_MAX_SWITCHES / GENERIC_EPS_SIM_HK_SWITCH_GROUP)
+#define GENERIC_EPS_SIM_SEG_BUS(n)          (n)
+#define GENERIC_EPS_SIM_SEG_MASK            5
+#define GENERIC_EPS_SIM_SEG_SWITCH(n)       (6 + (n) / GENERIC_EPS_SIM_HK_SWITCH_GROUP)
+
+namespace Nos3
+{
+    /*
+    ** HK telemetry frame for one EPS, encoded off the I2C path
+    ** Publishes are serialized by the caller, copies are lock free from any thread
+    */
+    class Generic_epsHkFrame
+    {
+    public:
+        explicit Generic_epsHkFrame(std::uint8_t num_switches);
+
+        void mark_dirty(std::uint8_t segment)
+        {
+            _dirty.fetch_or((std::uint16_t)(1 << segment), std::memory_order_relaxed);
+        }
+
+        void mark_all_dirty(void)
+        {
+            _dirty.store((std::uint16_t)((1 << _num_segments) - 1), std::memory_order_relaxed);
+        }
+
+        /* A switch change moves its mask bit and its voltage and current */
+        void mark_switch_dirty(std::uint8_t sw_num)
+        {
+            _dirty.fetch_or((std::uint16_t)((1 << GENERIC_EPS_SIM_SEG_MASK) | (1 << GENERIC_EPS_SIM_SEG_SWITCH(sw_num))), std::memory_order_relaxed);
+        }
+
+        /* Re-encode the dirty segments from the rails and swap the frame in */
+        void publish(const Generic_epsPowerModel::EPS_Rail* bus, const Generic_epsPowerModel::EPS_Rail* sw);
+
+        /* Latest published frame, get_frame_len() bytes */
+        void copy(std::uint8_t* out_data) const;
+
+        std::uint8_t  get_num_switches(void) const {return _num_switches;}
+        std::uint16_t get_frame_len(void) const {return _frame_len;}
+
+    private:
+        void encode(const Generic_epsPowerModel::EPS_Rail* bus, const Generic_epsPowerModel::EPS_Rail* sw);
+
+        std::uint8_t                _num_switches;
+        std::uint8_t                _num_segments;
+        std::uint16_t               _frame_len;
+
+        /* Working frame re-encoded only where rails changed, with the CRC state at each segment start */
+        std::uint16_t               _segment_offset[GENERIC_EPS_SIM_HK_MAX_SEGMENTS + 1];
+        std::uint8_t                _encode[GENERIC_EPS_SIM_HK_FRAME_MAX_LEN];
+        std::uint8_t                _crc_state[GENERIC_EPS_SIM_HK_MAX_SEGMENTS];
+        std::atomic<std::uint16_t>  _dirty;
+
+        /* Precomputed HK frames, the generation selects the current one */
+        std::uint8_t                _frame[2][GENERIC_EPS_SIM_HK_FRAME_MAX_LEN];
+        std::atomic<std::uint32_t>  _gen;
+    };
+}
+
+#endif
@@ -0,0 +1,108 @@
+#ifndef NOS3_GENERIC_EPSI2CDEVICE_HPP
+#define NOS3_GENERIC_EPSI2CDEVICE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <I2C/Client/I2CSlave.hpp>
+
+#include <generic_eps_core.hpp>
+#include <generic_eps_backdoor.hpp>
+#include <generic_eps_i2c_log.hpp>
+#include <generic_eps_i2c_timing.hpp>
+#include <generic_eps_switch_fanout.hpp>
+
+namespace Nos3
+{
+    /*
+    ** One EPS on its I2C address: the core and its backdoor keys, the I2C log and timing, and the nodes its switches power
+    ** Settings are read from simulator.hardware-model as the GENERIC_EPS model reads them.  The single and multi models
+    ** each own the time and command buses, the data provider and the fanout around one or more of these, and the
+    ** multi model the fleet its cores share.
+    */
+    class Generic_epsI2CDevice
+    {
+    public:
+        Generic_epsI2CDevice(const boost::property_tree::ptree& config, double absolute_start_time, std::int64_t microseconds_per_tick,
+            Generic_epsSwitchFanout& fanout, const std::string& connection_string, const std::string& bus_name, int bus_address,
+            Generic_epsCoreFleet* fleet);
+        ~Generic_epsI2CDevice(void);
+
+        /* Leave the I2C bus and write the trace, before the fanout it posts to goes away */
+        void close(void);
+
+        /* Time tick with the data provider's sun, replaced by the backdoor's while it holds one, for a core in a fleet of its own */
+        void tick(const Generic_epsSunVector& provided, std::uint64_t time);
+
+        /*
+        ** Record the sun of tick time in the I2C log and hold the log until the returned lock goes, so each I2C request
+        ** is logged on the side of the tick it reached the model on.  The lock is empty without a log.
+        */
+        std::unique_lock<std::mutex> record_sun(const Generic_epsSunVector& sun, std::uint64_t time);
+
+        /*
+        ** SET and GET statements, ENABLE, DISABLE, TRACE=, SAVE= and LOAD=, on an upper case command with its argument as sent
+        ** Returns false if the command is none of these.  Replies other than SET and GET start with prefix.
+        */
+        bool command(const std::string& command, const std::string& argument, const std::string& prefix, std::string& response);
+
+        /* Resets, writer and I2C timing counts for STATS */
+        std::string get_stats(void) const;
+
+        Generic_epsCore& get_core(void) {return _core;}
+        const Generic_epsCore& get_core(void) const {return _core;}
+
+    private:
+        /* Disallow these */
+        Generic_epsI2CDevice(const Generic_epsI2CDevice&);
+        Generic_epsI2CDevice& operator=(const Generic_epsI2CDevice&);
+
+        void notify_switch(std::uint8_t sw_num, bool on); /* Queue turning the simulator on a switch on or off */
+
+        /* Node notified when each switch changes, messages go out from the fanout worker */
+        Generic_epsSwitchFanout&                            _fanout;
+        std::vector<std::string>                            _switch_node_name;
+
+        /* Power model, HK frame and I2C command handling */
+        Generic_epsCore                                     _core;
+
+        /* SET and GET key table, built once for the switch count */
+        Generic_epsBackdoor                                 _backdoor;
+
+        /* Power model trace written by close */
+        std::string                                         _trace_file;
+
+        /* I2C traffic and sun record for generic_eps_i2c_replay, null unless configured */
+        std::unique_ptr<Generic_epsI2CLog>                  _i2c_log;
+
+        /* Bus and conversion time of each transaction, null unless a bus clock is configured */
+        std::unique_ptr<Generic_epsI2CTiming>               _i2c_timing;
+
+        class I2CSlaveConnection*                           _i2c_slave_connection;
+    };
+
+    class I2CSlaveConnection : public NosEngine::I2C::I2CSlave
+    {
+    public:
+        I2CSlaveConnection(Generic_epsCore* core, int bus_address, std::string connection_string, std::string bus_name,
+            Generic_epsI2CLog* log, Generic_epsI2CTiming* timing);
+        size_t i2c_read(uint8_t *rbuf, size_t rlen);
+        size_t i2c_write(const uint8_t *wbuf, size_t wlen);
+    private:
+        Generic_epsCore* _core;
+        Generic_epsI2CLog* _log;
+        Generic_epsI2CTiming* _timing;
+        bool _i2c_write_accepted; /* The next read is the rest of an acknowledged write */
+        bool _i2c_write_busy;     /* The last write was not acknowledged, its read gets no data */
+        std::uint8_t _i2c_read_valid;
+        Generic_epsI2CResponse _i2c_out_data;
+        std::size_t _i2c_out_len;
+    };
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef NOS3_GENERIC_EPSI2CLOG_HPP
+#define NOS3_GENERIC_EPSI2CLOG_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+#include <generic_eps_power_model.hpp>
+
+/*
+** I2C log layout: one Generic_epsI2CLogHeader followed by records in the order they happened
+** Each record is a Generic_epsI2CLogRecord and its payload, padded to a multiple of 8 bytes:
+**   I2C - the written bytes then the response bytes
+**   SUN - a Generic_epsI2CLogSun, logged when the sun at a tick differs from the last one logged
+** Sim time of a record is start_time + tick * microseconds_per_tick / 1e6
+*/
+#define GENERIC_EPS_I2C_LOG_MAGIC       "EPSI2CLG"
+#define GENERIC_EPS_I2C_LOG_VERSION     1
+#define GENERIC_EPS_I2C_LOG_TYPE_I2C    1
+#define GENERIC_EPS_I2C_LOG_TYPE_SUN    2
+#define GENERIC_EPS_I2C_LOG_ALIGN(n)    (((n) + 7) & ~(std::size_t)7)
+
+namespace Nos3
+{
+    struct Generic_epsI2CLogHeader
+    {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t record_size;
+        std::uint8_t  num_switches;
+        std::uint8_t  spare[7];
+        std::int64_t  microseconds_per_tick;
+        double        start_time;
+    };
+
+    struct Generic_epsI2CLogRecord
+    {
+        std::uint64_t tick;             /* Time bus tick the record happened after */
+        std::int64_t  wall_ns;          /* System clock, nanoseconds since the epoch */
+        std::uint8_t  type;
+        std::uint8_t  valid;            /* I2C result, GENERIC_EPS_SIM_SUCCESS when the write was accepted */
+        std::uint16_t write_len;
+        std::uint16_t read_len;
+        std::uint16_t spare;
+    };
+
+    struct Generic_epsI2CLogSun
+    {
+        double        x;
+        double        y;
+        double        z;
+        std::uint8_t  valid;
+        std::uint8_t  spare[7];
+    };
+
+    /*
+    ** Append only binary log of the I2C traffic of one EPS and the sun it saw, replayed by generic_eps_i2c_replay
+    ** Callers hold get_mutex() across the action and its record so the log order is the order the model saw
+    */
+    class Generic_epsI2CLog
+    {
+    public:
+        Generic_epsI2CLog(void);
+        ~Generic_epsI2CLog(void);
+
+        /* Start a new log, returns false if the file cannot be written */
+        bool open(const std::string& filename, std::uint8_t num_switches, std::int64_t microseconds_per_tick, double start_time);
+        void close(void);
+
+        void record_i2c(std::uint64_t tick, const std::uint8_t* wbuf, std::size_t wlen, std::uint8_t valid, const std::uint8_t* rbuf, std::size_t rlen);
+
+        /* Logs the sun only when it moved since the last call */
+        void record_sun(std::uint64_t tick, const Generic_epsSunVector& sun);
+
+        std::mutex& get_mutex(void) {return _mutex;}
+
+    private:
+        void append(const Generic_epsI2CLogRecord& rec, const void* a, std::size_t a_len, const void* b, std::size_t b_len);
+
+        std::mutex              _mutex;
+        std::FILE*              _fp;
+        Generic_epsI2CLogSun    _last_sun;
+        bool                    _have_sun;
+        std::int64_t            _last_flush_ns;
+    };
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef NOS3_GENERIC_EPSI2CTIMING_HPP
+#define NOS3_GENERIC_EPSI2CTIMING_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#define GENERIC_EPS_I2C_TIMING_BITS_PER_BYTE  9   /* Eight data bits and the acknowledge */
+
+namespace Nos3
+{
+    /*
+    ** Time the EPS would hold a real I2C bus, so FSW that runs transactions too close together sees a busy device
+    ** Each accepted transaction moves a busy deadline past its address and data bytes at the bus clock plus the
+    ** device conversion time; a transaction starting before that deadline is not acknowledged.
+    ** The deadline is only compared, nothing sleeps, so the callback returns at once and the rest of the bus runs on.
+    ** Called from the I2C callbacks only, the counters may be read from any thread.
+    */
+    class Generic_epsI2CTiming
+    {
+    public:
+        /* A bus clock of zero turns the timing off and every transaction is accepted */
+        Generic_epsI2CTiming(double bus_khz, double conversion_us);
+
+        bool is_enabled(void) const {return _ns_per_byte > 0;}
+
+        /* Write phase starting at now_ns, false if the device is still busy and must not acknowledge */
+        bool begin_write(std::int64_t now_ns, std::size_t wlen);
+
+        /* Read phase, after an accepted write in the same transaction it is always accepted, on its own it is checked like a write */
+        bool begin_read(std::int64_t now_ns, std::size_t rlen, bool follows_write);
+
+        std::uint64_t get_transactions(void) const {return _transactions.load(std::memory_order_relaxed);}
+        std::uint64_t get_busy(void) const {return _busy.load(std::memory_order_relaxed);}
+
+        /* Smallest gap seen between the busy deadline and the next transaction, negative once one came too soon */
+        std::int64_t  get_min_margin_ns(void) const {return _min_margin_ns.load(std::memory_order_relaxed);}
+
+        static std::int64_t now_ns(void);
+
+    private:
+        bool begin(std::int64_t now_ns, std::size_t len);
+
+        std::int64_t                _ns_per_byte;
+        std::int64_t                _conversion_ns;
+        std::int64_t                _busy_until_ns;
+        std::atomic<std::uint64_t>  _transactions;
+        std::atomic<std::uint64_t>  _busy;
+        std::atomic<std::int64_t>   _min_margin_ns;
+    };
+}
+
+#endif
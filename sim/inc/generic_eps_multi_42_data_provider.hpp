@@ -0,0 +1,43 @@
+#ifndef NOS3_GENERIC_EPSMULTI42DATAPROVIDER_HPP
+#define NOS3_GENERIC_EPSMULTI42DATAPROVIDER_HPP
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+#include <ItcLogger/Logger.hpp>
+#include <generic_eps_data_point.hpp>
+#include <generic_eps_sim_log.hpp>
+#include <sim_data_42socket_provider.hpp>
+
+namespace Nos3
+{
+    /* 42 data provider for every spacecraft in one connection, each frame is parsed once for all of them */
+    class Generic_epsMulti42DataProvider : public SimData42SocketProvider, public Generic_epsSunVectorFleetSource
+    {
+    public:
+        /* Constructors */
+        Generic_epsMulti42DataProvider(const boost::property_tree::ptree& config);
+
+        /* Accessors */
+        void get_sun_vectors(const std::vector<std::int16_t>& spacecraft, std::vector<Generic_epsSunVector>& out) const;
+        std::uint64_t get_cache_hits(void) const {return _cache_hits.load(std::memory_order_relaxed);}
+        std::uint64_t get_cache_misses(void) const {return _cache_misses.load(std::memory_order_relaxed);}
+
+    private:
+        /* Disallow these */
+        ~Generic_epsMulti42DataProvider(void) {};
+        Generic_epsMulti42DataProvider& operator=(const Generic_epsMulti42DataProvider&) {return *this;};
+
+        /* Sun vectors for the last 42 frame by spacecraft number, re-parsed only when the frame time changes */
+        mutable std::mutex                        _cache_mutex;
+        mutable std::string                       _cache_time;
+        mutable std::vector<Generic_epsSunVector> _cache_sun;
+        mutable std::atomic<std::uint64_t>        _cache_hits;
+        mutable std::atomic<std::uint64_t>        _cache_misses;
+    };
+}
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef NOS3_GENERIC_EPSMULTIHARDWAREMODEL_HPP
+#define NOS3_GENERIC_EPSMULTIHARDWAREMODEL_HPP
+
+/*
+** Includes
+*/
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <generic_eps_hardware_model.hpp>
+#include <generic_eps_multi_42_data_provider.hpp>
+
+
+/*
+** Namespace
+*/
+namespace Nos3
+{
+    /*
+    ** One EPS per spacecraft in a single simulator process
+    ** The instances share the time bus, command bus, data provider and fanout, each is a Generic_epsI2CDevice on its own I2C address
+    ** Their cores share one fleet, so every instance's rails, switches and battery are stepped in one pass per tick
+    */
+    class Generic_epsMultiHardwareModel : public SimIHardwareModel
+    {
+    public:
+        /* Constructor and destructor */
+        Generic_epsMultiHardwareModel(const boost::property_tree::ptree& config);
+        ~Generic_epsMultiHardwareModel(void);
+
+    private:
+        /* Private helper methods */
+        void command_callback(NosEngine::Common::Message msg); /* Handle backdoor commands and time tick to the simulator */
+        void update_battery_values(void);
+
+        /* Private data members */
+        std::string                                         _command_bus_name;
+        std::unique_ptr<NosEngine::Client::Bus>             _command_bus; /* Standard */
+
+        /* Switch changes of every instance go out from one fanout worker */
+        std::unique_ptr<Generic_epsSwitchFanout>            _fanout;
+
+        SimIDataProvider*                                   _generic_eps_dp;
+        Generic_epsSunVectorFleetSource*                    _fleet_source; /* All spacecraft from one 42 parse */
+        Generic_epsSunVectorSource*                         _sun_source;   /* Otherwise the same sun for every instance */
+
+        /* Time Bus */
+        std::unique_ptr<NosEngine::Client::Bus>             _time_bus;
+
+        /* Every instance's power state, made before and destroyed after the devices whose cores index it */
+        Generic_epsCoreFleet                                _fleet;
+
+        /* One EPS per instance, with the spacecraft each one follows and the I2C bus and address it answers on */
+        std::vector<std::unique_ptr<Generic_epsI2CDevice>>  _devices;
+        std::vector<std::int16_t>                           _spacecraft;
+        std::vector<std::pair<std::string, int>>            _bus;
+
+        /* Tick scratch, indexed by instance */
+        std::vector<Generic_epsSunVector>                   _sun;
+        std::vector<std::unique_lock<std::mutex>>           _log_locks;
+    };
+}
+
+#endif
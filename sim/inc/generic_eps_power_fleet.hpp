@@ -0,0 +1,87 @@
+#ifndef NOS3_GENERIC_EPSPOWERFLEET_HPP
+#define NOS3_GENERIC_EPSPOWERFLEET_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <generic_eps_power_model.hpp>
+#include <generic_eps_trace.hpp>
+
+namespace Nos3
+{
+    /*
+    ** Power models for many spacecraft in struct of arrays form
+    ** The per tick state sits in one array per field so a step is a single contiguous pass,
+    ** each instance gives exactly the results of the Generic_epsPowerModel it was added from
+    ** Not thread safe, callers serialize access
+    */
+    class Generic_epsPowerFleet
+    {
+    public:
+        Generic_epsPowerFleet(void) : _switch_offset(1, 0) {}
+
+        /* Append an instance starting from the state of model, returns its index */
+        std::size_t add(const Generic_epsPowerModel& model);
+
+        std::size_t size(void) const {return _battery_pwh.size();}
+
+        /* Room for instances with switches between them, so adding up to that many never moves the arrays */
+        void reserve(std::size_t instances, std::size_t switches);
+
+        /*
+        ** Step every instance, arrays are indexed by instance: ticks of seconds each at sun, changed is set when the
+        ** battery voltage changed.  An instance with zero ticks is left as it is.
+        */
+        void step(double seconds, const Generic_epsSunVector* sun, const std::uint64_t* ticks, std::uint8_t* changed);
+
+        /* Instance n alone, as Generic_epsPowerModel::advance; true if the battery voltage changed */
+        bool advance(std::size_t n, double seconds, const Generic_epsSunVector& sun, std::uint64_t ticks);
+
+        /* Put instance n back to the state of model, as add would start it; false if the switch count differs */
+        bool restore(std::size_t n, const Generic_epsPowerModel& model);
+
+        /* Copy the state of instance n into a model built from the same config, false if the switch count differs */
+        bool store(std::size_t n, Generic_epsPowerModel& model) const;
+
+        /* True if the status changed, switch numbers past the instance's count are ignored */
+        bool set_switch_status(std::size_t n, std::uint8_t sw_num, std::uint16_t sw_status);
+
+        void set_battery_watthrs(std::size_t n, double watthrs);
+
+        /* Fill a trace record with the state of instance n after its last step */
+        void fill_trace_record(std::size_t n, double sim_time, Generic_epsTraceRecord& rec) const;
+
+        /* Accessors */
+        const Generic_epsPowerModel::EPS_Rail* get_bus(std::size_t n) const {return &_bus[n * GENERIC_EPS_POWER_NUM_BUSES];}
+        const Generic_epsPowerModel::EPS_Rail* get_switch(std::size_t n) const {return _switch.data() + _switch_offset[n];}
+        std::uint8_t    get_num_switches(std::size_t n) const {return (std::uint8_t)(_switch_offset[n + 1] - _switch_offset[n]);}
+        double          get_battery_watthrs(std::size_t n) const {return _battery_pwh[n] / GENERIC_EPS_POWER_PWH_PER_WH;}
+        std::int64_t    get_battery_pwh(std::size_t n) const {return _battery_pwh[n];}
+        double          get_p_in(std::size_t n) const {return _p_in[n];}
+        double          get_p_out(std::size_t n) const {return _load_uw[n] / 1000000.0;}
+        std::uint64_t   get_switch_mask(std::size_t n) const {return _switch_mask[n];}
+
+    private:
+        std::int64_t switch_load_uw(std::size_t n, std::uint8_t sw_num) const;
+        bool set_battery_voltage(std::size_t n); /* From the charge, true if it changed */
+
+        /* Read or written by every step */
+        std::vector<double>                             _power_per_panel;
+        std::vector<double>                             _batt_min_voltage;
+        std::vector<double>                             _batt_diff;
+        std::vector<double>                             _max_battery;
+        std::vector<std::int64_t>                       _load_uw;
+        std::vector<std::int64_t>                       _battery_pwh;
+        std::vector<double>                             _p_in;
+        std::vector<double>                             _step_p_in;  /* Scratch between the two passes */
+        std::vector<double>                             _delta_pwh;  /* Scratch between the two passes */
+
+        /* Rails for encoding and switch changes, GENERIC_EPS_POWER_NUM_BUSES per instance, switches of instance n start at _switch_offset[n] */
+        std::vector<Generic_epsPowerModel::EPS_Rail>    _bus;
+        std::vector<Generic_epsPowerModel::EPS_Rail>    _switch;
+        std::vector<std::size_t>                        _switch_offset;
+        std::vector<std::uint64_t>                      _switch_mask;
+    };
+}
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef NOS3_GENERIC_EPSPOWERMODEL_HPP
+#define NOS3_GENERIC_EPSPOWERMODEL_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <generic_eps_trace.hpp>
+
+#define GENERIC_EPS_POWER_NUM_BUSES     5
+#define GENERIC_EPS_POWER_NUM_SWITCHES  8   /* Default for physical.switch-count */
+#define GENERIC_EPS_POWER_MAX_SWITCHES  64  /* One bit each in the switch mask, below the 0x70 command code */
+
+/* Battery energy is accumulated in integer picowatt-hours so n ticks at once equal n single ticks exactly */
+#define GENERIC_EPS_POWER_PWH_PER_WH    1000000000000.0
+
+namespace Nos3
+{
+    /* Sun vector sample passed by value, no allocation or casting needed */
+    struct Generic_epsSunVector
+    {
+        double x;
+        double y;
+        double z;
+        bool   valid;
+    };
+
+    /*
+    ** Battery, solar array and switch model with no NOS Engine dependency
+    ** The hardware model steps it once per time tick, batch tools step it directly
+    ** Not thread safe, callers serialize access
+    */
+    class Generic_epsPowerModel
+    {
+    public:
+        struct EPS_Rail
+        {
+            std::uint16_t _voltage;
+            std::uint16_t _current;
+            std::uint16_t _status;
+            std::uint16_t _temperature;
+            double        _battery_watthrs;
+        };
+
+        /* Reads simulator.hardware-model.physical from the simulator configuration */
+        explicit Generic_epsPowerModel(const boost::property_tree::ptree& config);
+
+        /* Advance the battery by seconds of sun exposure, true if the battery voltage changed */
+        bool step(double seconds, const Generic_epsSunVector& sun) {return advance(seconds, sun, 1);}
+
+        /* Closed form for ticks steps of seconds each with constant sun and load, bit identical to stepping them one by one */
+        bool advance(double seconds, const Generic_epsSunVector& sun, std::uint64_t ticks);
+
+        /* True if the status changed, switch numbers past the configured count are ignored */
+        bool set_switch_status(std::uint8_t sw_num, std::uint16_t sw_status);
+
+        /* Replace voltage, current, status and temperature of a rail, the load total and switch mask follow and the battery charge is kept */
+        void set_bus(std::uint8_t bus_num, const EPS_Rail& rail);
+        void set_switch(std::uint8_t sw_num, const EPS_Rail& rail);
+
+        /* Start from a given charge rather than a full battery */
+        void set_battery_watthrs(double watthrs);
+
+        /* Replace the rails and the battery charge with saved ones, false if the switch count differs */
+        bool restore(const EPS_Rail* bus, const EPS_Rail* sw, std::uint8_t num_switches, std::int64_t battery_pwh, double p_in);
+
+        /* Accessors */
+        const EPS_Rail& get_bus(std::uint8_t bus_num) const {return _bus[bus_num];}
+        const EPS_Rail& get_switch(std::uint8_t sw_num) const {return _switch[sw_num];}
+        const EPS_Rail* get_switches(void) const {return _switch.data();}
+        std::uint8_t    get_num_switches(void) const {return (std::uint8_t)_switch.size();}
+        double          get_battery_watthrs(void) const {return _bus[0]._battery_watthrs;}
+        double          get_max_battery_watthrs(void) const {return _max_battery;}
+        std::int64_t    get_battery_pwh(void) const {return _battery_pwh;}
+        double          get_power_per_panel(void) const {return _power_per_panel;}
+        double          get_nominal_battery_voltage(void) const {return _nominal_batt_voltage;}
+        std::int64_t    get_load_uw(void) const {return _load_uw;}
+        double          get_p_in(void) const {return _p_in;}
+        double          get_p_out(void) const {return _load_uw / 1000000.0;}
+        std::uint64_t   get_switch_mask(void) const {return _switch_mask;}
+
+        /* Fill a trace record with the state after the last step */
+        void fill_trace_record(double sim_time, Generic_epsTraceRecord& rec) const;
+
+    private:
+        void recompute_load(void); /* Load total and switch mask from scratch */
+        std::int64_t bus_load_uw(std::uint8_t bus_num) const;   /* Load of one regulated rail, mV * mA = uW */
+        std::int64_t switch_load_uw(std::uint8_t sw_num) const; /* Load of one switch, zero while off */
+
+        std::vector<EPS_Rail>                               _switch;
+        EPS_Rail                                            _bus[GENERIC_EPS_POWER_NUM_BUSES];
+                                                                /*
+                                                                0 - Battery
+                                                                1 - 3.3v
+                                                                2 - 5.0v
+                                                                3 - 12.0v
+                                                                4 - Solar Array
+                                                                */
+
+        /* Running load total and on switches, kept up to date on every rail or switch change */
+        std::int64_t                                        _load_uw;
+        std::uint64_t                                       _switch_mask;
+        double                                              _p_in;
+
+        /* Battery charge, _bus[0]._battery_watthrs follows it */
+        std::int64_t                                        _battery_pwh;
+
+        double                                              _power_per_panel;
+        double                                              _max_battery;
+        double                                              _nominal_batt_voltage;
+    };
+}
+
+#endif
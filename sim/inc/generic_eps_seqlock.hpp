@@ -0,0 +1,69 @@
+#ifndef NOS3_GENERIC_EPSSEQLOCK_HPP
+#define NOS3_GENERIC_EPSSEQLOCK_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace Nos3
+{
+    /*
+    ** Sequence lock for state shared between the writer and I2C callbacks
+    ** There is only ever one writer, callers hold the Generic_epsCoreFleet writer role around a write, so a write
+    ** only marks its update with an odd sequence number.  Readers never block and retry if a write overlapped their copy.
+    */
+    class Generic_epsSeqlock
+    {
+    public:
+        Generic_epsSeqlock(void) : _seq(0) {}
+
+        void write_lock(void)
+        {
+            _seq.store(_seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        void write_unlock(void)
+        {
+            _seq.store(_seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        std::uint32_t read_begin(void) const
+        {
+            std::uint32_t seq;
+            while ((seq = _seq.load(std::memory_order_acquire)) & 1)
+            {
+                std::this_thread::yield();
+            }
+            return seq;
+        }
+
+        bool read_retry(std::uint32_t seq) const
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return _seq.load(std::memory_order_relaxed) != seq;
+        }
+
+        /* Writes so far, wraps at 2^31 */
+        std::uint64_t get_writes(void) const {return _seq.load(std::memory_order_relaxed) / 2;}
+
+    private:
+        std::atomic<std::uint32_t> _seq;
+    };
+
+    /* Scoped writer section */
+    class Generic_epsSeqlockWriter
+    {
+    public:
+        explicit Generic_epsSeqlockWriter(Generic_epsSeqlock& lock) : _lock(lock) {_lock.write_lock();}
+        ~Generic_epsSeqlockWriter(void) {_lock.write_unlock();}
+
+    private:
+        Generic_epsSeqlockWriter(const Generic_epsSeqlockWriter&);
+        Generic_epsSeqlockWriter& operator=(const Generic_epsSeqlockWriter&);
+
+        Generic_epsSeqlock& _lock;
+    };
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef NOS3_GENERIC_EPSSIMLOG_HPP
+#define NOS3_GENERIC_EPSSIMLOG_HPP
+
+#include <atomic>
+#include <string>
+
+#include <ItcLogger/Logger.hpp>
+
+/*
+** Log levels, lowest is most verbose
+*/
+#define GENERIC_EPS_SIM_LOG_TRACE   0
+#define GENERIC_EPS_SIM_LOG_DEBUG   1
+#define GENERIC_EPS_SIM_LOG_INFO    2
+#define GENERIC_EPS_SIM_LOG_WARNING 3
+#define GENERIC_EPS_SIM_LOG_ERROR   4
+#define GENERIC_EPS_SIM_LOG_OFF     5
+
+/* Messages below this level are compiled out, trace is dropped from release builds */
+#ifndef GENERIC_EPS_SIM_LOG_COMPILE_LEVEL
+    #ifdef NDEBUG
+        #define GENERIC_EPS_SIM_LOG_COMPILE_LEVEL GENERIC_EPS_SIM_LOG_DEBUG
+    #else
+        #define GENERIC_EPS_SIM_LOG_COMPILE_LEVEL GENERIC_EPS_SIM_LOG_TRACE
+    #endif
+#endif
+
+/*
+** Arguments are only evaluated when the message will be emitted,
+** so hex dumps and to_string() calls cost nothing while the level is off
+*/
+#define GENERIC_EPS_SIM_LOG(level, method, ...) \
+    do \
+    { \
+        if (((level) >= GENERIC_EPS_SIM_LOG_COMPILE_LEVEL) && Nos3::Generic_epsSimLog::enabled(level)) \
+        { \
+            sim_logger->method(__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define GENERIC_EPS_SIM_TRACE(...) GENERIC_EPS_SIM_LOG(GENERIC_EPS_SIM_LOG_TRACE, trace, __VA_ARGS__)
+#define GENERIC_EPS_SIM_DEBUG(...) GENERIC_EPS_SIM_LOG(GENERIC_EPS_SIM_LOG_DEBUG, debug, __VA_ARGS__)
+
+namespace Nos3
+{
+    /*
+    ** Runtime level gate checked before any message arguments are formatted.  It can only drop messages,
+    ** sim_logger still applies its configured level to what passes, so by default everything passes.
+    */
+    class Generic_epsSimLog
+    {
+    public:
+        static bool enabled(int level) {return level >= _level.load(std::memory_order_relaxed);}
+        static int  get_level(void) {return _level.load(std::memory_order_relaxed);}
+        static void set_level(int level) {_level.store(level, std::memory_order_relaxed);}
+        static bool set_level(const std::string& name); /* TRACE, DEBUG, INFO, WARNING, ERROR or OFF */
+
+    private:
+        static std::atomic<int> _level;
+    };
+}
+
+#endif
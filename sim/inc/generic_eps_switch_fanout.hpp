@@ -0,0 +1,73 @@
+#ifndef NOS3_GENERIC_EPSSWITCHFANOUT_HPP
+#define NOS3_GENERIC_EPSSWITCHFANOUT_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Nos3
+{
+    /*
+    ** Delivers switch changes to the simulators they power from a worker thread, off the I2C and tick paths
+    ** Changes are queued per node: while one waits, later changes for the same node replace it, so a burst
+    ** of toggles or several switches on one node end in one message with the final state.  A final state
+    ** the node was already sent is dropped.  Nodes are sent in the order they were first queued.
+    */
+    class Generic_epsSwitchFanout
+    {
+    public:
+        /* Called on the worker thread only */
+        typedef std::function<void(const std::string& node, bool on)> Send;
+
+        explicit Generic_epsSwitchFanout(Send send);
+        ~Generic_epsSwitchFanout(void); /* Sends what is queued, then stops the worker */
+
+        /* Never blocks on delivery */
+        void post(const std::string& node, bool on);
+
+        /* Counters and latency from the first queued change of a node to its message going out */
+        std::uint64_t get_posted(void) const {return _posted.load(std::memory_order_relaxed);}
+        std::uint64_t get_sent(void) const {return _sent.load(std::memory_order_relaxed);}
+        std::uint64_t get_max_latency_ns(void) const {return _max_latency_ns.load(std::memory_order_relaxed);}
+        std::uint64_t get_mean_latency_ns(void) const;
+
+        /* One line summary for the STATS backdoor commands */
+        std::string get_stats(void) const;
+
+    private:
+        struct Pending
+        {
+            bool         on;
+            std::int64_t queued_ns;
+        };
+
+        void worker(void);
+
+        Send                                            _send;
+
+        /* Guarded by _mutex */
+        std::mutex                                      _mutex;
+        std::condition_variable                         _wake;
+        std::unordered_map<std::string, Pending>        _pending;
+        std::vector<std::string>                        _order;
+        bool                                            _stop;
+
+        /* Worker thread only, last state sent to each node */
+        std::unordered_map<std::string, bool>           _delivered;
+
+        std::atomic<std::uint64_t>                      _posted;
+        std::atomic<std::uint64_t>                      _sent;
+        std::atomic<std::uint64_t>                      _total_latency_ns;
+        std::atomic<std::uint64_t>                      _max_latency_ns;
+
+        std::thread                                     _thread;
+    };
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef NOS3_GENERIC_EPSTRACE_HPP
+#define NOS3_GENERIC_EPSTRACE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+** Trace file layout: one Generic_epsTraceHeader followed by count records, oldest first
+*/
+#define GENERIC_EPS_TRACE_MAGIC         "EPSTRACE"
+#define GENERIC_EPS_TRACE_VERSION       1
+#define GENERIC_EPS_TRACE_DEFAULT_DEPTH 65536
+
+namespace Nos3
+{
+    /* Power model state captured once per time tick */
+    struct Generic_epsTraceRecord
+    {
+        double        sim_time;         /* Seconds */
+        double        battery_watthrs;
+        float         p_in;             /* Watts from the solar arrays */
+        float         p_out;            /* Watts drawn by the loads */
+        std::uint64_t switch_mask;      /* Bit n set when switch n is on */
+        std::uint16_t battery_mv;
+        std::uint16_t spare[3];
+    };
+
+    struct Generic_epsTraceHeader
+    {
+        char          magic[8];
+        std::uint32_t version;
+        std::uint32_t record_size;
+        std::uint64_t count;
+    };
+
+    /*
+    ** Fixed size ring of trace records
+    ** One producer (the time tick) records without locking, any thread may dump
+    */
+    class Generic_epsTrace
+    {
+    public:
+        explicit Generic_epsTrace(std::uint32_t depth = GENERIC_EPS_TRACE_DEFAULT_DEPTH);
+
+        void record(const Generic_epsTraceRecord& rec)
+        {
+            std::uint64_t head = _head.load(std::memory_order_relaxed);
+            _records[head & _mask] = rec;
+            _head.store(head + 1, std::memory_order_release);
+        }
+
+        std::uint64_t total(void) const {return _head.load(std::memory_order_acquire);}
+
+        /* Copy out the records still held, oldest first */
+        void snapshot(std::vector<Generic_epsTraceRecord>& out) const;
+
+        /* Write a snapshot to a trace file, returns the number of records written or -1 on error */
+        std::int64_t dump(const std::string& filename) const;
+
+        /* Write records to a trace file, shared with the batch runner */
+        static std::int64_t write(const std::string& filename, const std::vector<Generic_epsTraceRecord>& recs);
+
+        /* Read a trace file written by dump, returns false if the file is not a valid trace */
+        static bool load(const std::string& filename, std::vector<Generic_epsTraceRecord>& out);
+
+    private:
+        std::vector<Generic_epsTraceRecord> _records;
+        std::uint64_t                       _mask;
+        std::atomic<std::uint64_t>          _head;
+    };
+}
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef NOS3_GENERIC_EPSWORKPOOL_HPP
+#define NOS3_GENERIC_EPSWORKPOOL_HPP
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Nos3
+{
+    /*
+    ** Runs job indices [0, count) across worker threads
+    ** Each worker owns a contiguous range and takes from its front, an idle worker
+    ** steals the back half of another range so uneven run times still balance
+    */
+    class Generic_epsWorkPool
+    {
+    public:
+        explicit Generic_epsWorkPool(unsigned workers) : _ranges((workers > 0) ? workers : 1) {}
+
+        unsigned get_workers(void) const {return _ranges.size();}
+
+        /* Blocks until every index has run, job is called as job(index, worker) */
+        void run(std::uint64_t count, const std::function<void(std::uint64_t, unsigned)>& job)
+        {
+            std::vector<std::thread> threads;
+            unsigned w;
+
+            for (w = 0; w < _ranges.size(); w++)
+            {
+                _ranges[w].begin = count * w / _ranges.size();
+                _ranges[w].end = count * (w + 1) / _ranges.size();
+            }
+            for (w = 1; w < _ranges.size(); w++)
+            {
+                threads.push_back(std::thread(&Generic_epsWorkPool::worker, this, w, std::cref(job)));
+            }
+            worker(0, job);
+            for (w = 0; w < threads.size(); w++)
+            {
+                threads[w].join();
+            }
+        }
+
+    private:
+        struct Range
+        {
+            std::mutex    lock;
+            std::uint64_t begin;
+            std::uint64_t end;
+        };
+
+        bool take(unsigned w, std::uint64_t& index)
+        {
+            std::lock_guard<std::mutex> guard(_ranges[w].lock);
+            if (_ranges[w].begin < _ranges[w].end)
+            {
+                index = _ranges[w].begin++;
+                return true;
+            }
+            return false;
+        }
+
+        /* Move the back half of the victim range to worker w, one job from the front is returned */
+        bool steal(unsigned w, std::uint64_t& index)
+        {
+            unsigned i;
+            for (i = 1; i < _ranges.size(); i++)
+            {
+                unsigned victim = (w + i) % _ranges.size();
+                std::uint64_t begin, end;
+                {
+                    std::lock_guard<std::mutex> guard(_ranges[victim].lock);
+                    std::uint64_t left = _ranges[victim].end - _ranges[victim].begin;
+                    if (left == 0)
+                    {
+                        continue;
+                    }
+                    end = _ranges[victim].end;
+                    begin = end - (left + 1) / 2;
+                    _ranges[victim].end = begin;
+                }
+                std::lock_guard<std::mutex> guard(_ranges[w].lock);
+                index = begin;
+                _ranges[w].begin = begin + 1;
+                _ranges[w].end = end;
+                return true;
+            }
+            return false;
+        }
+
+        /* Jobs never add work, so one pass finding every range empty means done */
+        void worker(unsigned w, const std::function<void(std::uint64_t, unsigned)>& job)
+        {
+            std::uint64_t index;
+            while (take(w, index) || steal(w, index))
+            {
+                job(index, w);
+            }
+        }
+
+        std::vector<Range> _ranges;
+    };
+}
+
+#endif
@@ -6,27 +6,67 @@ namespace Nos3
 
     extern ItcLogger::Logger *sim_logger;
 
-    Generic_eps42DataProvider::Generic_eps42DataProvider(const boost::property_tree::ptree& config) : SimData42SocketProvider(config)
+    Generic_eps42DataProvider::Generic_eps42DataProvider(const boost::property_tree::ptree& config) : SimData42SocketProvider(config),
+        _cache_hits(0), _cache_misses(0)
     {
-        sim_logger->trace("Generic_eps42DataProvider::Generic_eps42DataProvider:  Constructor executed");
+        _cache_sun.valid = false;
+        _cache_sun.x = 0.0;
+        _cache_sun.y = 0.0;
+        _cache_sun.z = 0.0;
+
+        GENERIC_EPS_SIM_TRACE("Generic_eps42DataProvider::Generic_eps42DataProvider:  Constructor executed");
 
         connect_reader_thread_as_42_socket_client(
             config.get("simulator.hardware-model.data-provider.hostname", "localhost"),
             config.get("simulator.hardware-model.data-provider.port", 4242) );
 
         _sc = config.get("simulator.hardware-model.data-provider.spacecraft", 0);
+
+        /* Sun-pointing unit vector, expressed in SC.B[0] [~=~] */
+        std::ostringstream prefix;
+        prefix << "SC[" << _sc << "].svb = ";
+        _svb_prefix = prefix.str();
     }
 
-    boost::shared_ptr<SimIDataPoint> Generic_eps42DataProvider::get_data_point(void) const
+    void Generic_eps42DataProvider::refresh_cache(void) const
+    {
+        /* Get the 42 data, the socket provider hands out the same point until a new frame lands */
+        const boost::shared_ptr<Sim42DataPoint> dp42 = boost::static_pointer_cast<Sim42DataPoint>(SimData42SocketProvider::get_data_point());
+
+        if ((_cache_frame) && (dp42 == _cache_frame))
+        {
+            _cache_hits.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        /* Prepare the specific data, holding the frame keeps its address from being reused */
+        _cache_misses.fetch_add(1, std::memory_order_relaxed);
+        _cache_frame = dp42;
+        _cache_sun = Generic_epsDataPoint::parse_sun_vector(_svb_prefix, dp42);
+        _cache_point.reset();
+    }
+
+    Generic_epsSunVector Generic_eps42DataProvider::get_sun_vector(void) const
     {
-        sim_logger->trace("Generic_eps42DataProvider::get_data_point:  Executed");
+        GENERIC_EPS_SIM_TRACE("Generic_eps42DataProvider::get_sun_vector:  Executed");
+
+        std::lock_guard<std::mutex> lock(_cache_mutex);
+        refresh_cache();
+        return _cache_sun;
+    }
 
-        /* Get the 42 data */
-        const boost::shared_ptr<Sim42DataPoint> dp42 = boost::dynamic_pointer_cast<Sim42DataPoint>(SimData42SocketProvider::get_data_point());
+    boost::shared_ptr<SimIDataPoint> Generic_eps42DataProvider::get_data_point(void) const
+    {
+        GENERIC_EPS_SIM_TRACE("Generic_eps42DataProvider::get_data_point:  Executed");
 
-        /* Prepare the specific data */
-        SimIDataPoint *dp = new Generic_epsDataPoint(_sc, dp42);
+        std::lock_guard<std::mutex> lock(_cache_mutex);
+        refresh_cache();
+        if (!_cache_point)
+        {
+            SimIDataPoint *dp = new Generic_epsDataPoint(_cache_sun);
+            _cache_point.reset(dp);
+        }
 
-        return boost::shared_ptr<SimIDataPoint>(dp);
+        return _cache_point;
     }
 }
@@ -0,0 +1,305 @@
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+#include <boost/algorithm/string.hpp>
+
+#include <generic_eps_backdoor.hpp>
+#include <generic_eps_power_model.hpp>
+
+namespace Nos3
+{
+    Generic_epsBackdoor::Generic_epsBackdoor(std::uint8_t num_switches)
+    {
+        typedef Generic_epsBackdoorParam P;
+        std::uint8_t i;
+
+        /* Rails hold mV, mA and (C + 60) * 100 in 16 bits */
+        for (i = 0; i < GENERIC_EPS_POWER_NUM_BUSES; i++)
+        {
+            std::string prefix = "bus." + std::to_string(i) + ".";
+            add(prefix + "voltage", P::BUS, P::VOLTAGE, i, true, 0.0, 65.535);
+            add(prefix + "current", P::BUS, P::CURRENT, i, true, 0.0, 65.535);
+            add(prefix + "temperature", P::BUS, P::TEMPERATURE, i, true, -60.0, 595.35);
+            add(prefix + "status", P::BUS, P::STATUS, i, true, 0.0, 65535.0);
+            if (i == 0)
+            {
+                add(prefix + "watthrs", P::BUS, P::WATTHRS, i, true, 0.0, 1000000.0);
+            }
+        }
+        for (i = 0; i < num_switches; i++)
+        {
+            std::string prefix = "switch." + std::to_string(i) + ".";
+            add(prefix + "voltage", P::SWITCH, P::VOLTAGE, i, true, 0.0, 65.535);
+            add(prefix + "current", P::SWITCH, P::CURRENT, i, true, 0.0, 65.535);
+            add(prefix + "temperature", P::SWITCH, P::TEMPERATURE, i, true, -60.0, 595.35);
+            add(prefix + "status", P::SWITCH, P::STATUS, i, true, 0.0, 65535.0);
+            add(prefix + "state", P::SWITCH, P::STATE, i, true, 0.0, 1.0);
+        }
+
+        /* Setting a component holds the sun there instead of the data provider until sun.override=0 */
+        add("sun.x", P::SUN, P::X, 0, true, -1.0, 1.0);
+        add("sun.y", P::SUN, P::Y, 0, true, -1.0, 1.0);
+        add("sun.z", P::SUN, P::Z, 0, true, -1.0, 1.0);
+        add("sun.override", P::SUN, P::OVERRIDE, 0, true, 0.0, 1.0);
+
+        add("enabled", P::ENABLED, P::VALUE, 0, true, 0.0, 1.0);
+        add("time", P::TIME, P::VALUE, 0, false, 0.0, 0.0);
+        add("power.in", P::POWER, P::P_IN, 0, false, 0.0, 0.0);
+        add("power.out", P::POWER, P::P_OUT, 0, false, 0.0, 0.0);
+
+        /* 1 once the simulators on switches that start on have been sent their enable */
+        add("ready", P::READY, P::VALUE, 0, false, 0.0, 0.0);
+        add("resets", P::RESETS, P::VALUE, 0, false, 0.0, 0.0);
+    }
+
+    void Generic_epsBackdoor::add(const std::string& name, Generic_epsBackdoorParam::Target target, Generic_epsBackdoorParam::Field field,
+        std::uint8_t index, bool writable, double min, double max)
+    {
+        Generic_epsBackdoorParam param = {name, target, field, index, writable, min, max};
+        _table[name] = _params.size();
+        _params.push_back(param);
+    }
+
+    bool Generic_epsBackdoor::is_request(const std::string& command)
+    {
+        std::size_t start = command.find_first_not_of(" \t");
+        if ((start == std::string::npos) || (command.size() < start + 3))
+        {
+            return false;
+        }
+        std::string keyword = boost::to_upper_copy(command.substr(start, 3));
+        return ((keyword == "SET") || (keyword == "GET")) &&
+            ((command.size() == start + 3) || std::isspace((unsigned char)command[start + 3]) || (command[start + 3] == ';'));
+    }
+
+    bool Generic_epsBackdoor::parse(const std::string& command, Generic_epsBackdoorRequest& request, std::string& error) const
+    {
+        std::vector<std::string> statements;
+        std::size_t i;
+
+        request.ops.clear();
+        boost::split(statements, command, boost::is_any_of(";"));
+        for (i = 0; i < statements.size(); i++)
+        {
+            std::istringstream words(statements[i]);
+            std::string keyword, word;
+            if (!(words >> keyword))
+            {
+                continue; /* Empty statement, e.g. a trailing ';' */
+            }
+            boost::to_upper(keyword);
+            bool set = (keyword == "SET");
+            if (!set && (keyword != "GET"))
+            {
+                error = "unknown statement " + keyword + ", expected SET or GET";
+                return false;
+            }
+
+            bool empty = true;
+            while (words >> word)
+            {
+                empty = false;
+                if (set)
+                {
+                    std::size_t eq = word.find('=');
+                    if ((eq == std::string::npos) || (eq == 0))
+                    {
+                        error = "expected key=value, got " + word;
+                        return false;
+                    }
+                    std::string key = boost::to_lower_copy(word.substr(0, eq));
+                    std::unordered_map<std::string, std::size_t>::const_iterator it = _table.find(key);
+                    if (it == _table.end())
+                    {
+                        error = "unknown key " + key;
+                        return false;
+                    }
+                    const Generic_epsBackdoorParam& param = _params[it->second];
+                    Generic_epsBackdoorRequest::Op op = {&param, true, 0.0};
+                    if (!param.writable)
+                    {
+                        error = key + " is read only";
+                        return false;
+                    }
+                    if (!parse_value(word.substr(eq + 1), op.value))
+                    {
+                        error = "bad value " + word.substr(eq + 1) + " for " + key;
+                        return false;
+                    }
+                    if (!in_range(param, op.value))
+                    {
+                        std::ostringstream range;
+                        range << param.min << " to " << param.max;
+                        error = key + " out of range, expected " + range.str();
+                        return false;
+                    }
+                    request.ops.push_back(op);
+                }
+                else
+                {
+                    std::string pattern = boost::to_lower_copy(word);
+                    if (pattern.find('*') == std::string::npos)
+                    {
+                        std::unordered_map<std::string, std::size_t>::const_iterator it = _table.find(pattern);
+                        if (it == _table.end())
+                        {
+                            error = "unknown key " + pattern;
+                            return false;
+                        }
+                        Generic_epsBackdoorRequest::Op op = {&_params[it->second], false, 0.0};
+                        request.ops.push_back(op);
+                    }
+                    else
+                    {
+                        /* Patterns list the parameters in table order */
+                        std::size_t before = request.ops.size();
+                        std::vector<Generic_epsBackdoorParam>::const_iterator p;
+                        for (p = _params.begin(); p != _params.end(); ++p)
+                        {
+                            if (match(pattern.c_str(), p->name.c_str()))
+                            {
+                                Generic_epsBackdoorRequest::Op op = {&(*p), false, 0.0};
+                                request.ops.push_back(op);
+                            }
+                        }
+                        if (request.ops.size() == before)
+                        {
+                            error = "no key matches " + pattern;
+                            return false;
+                        }
+                    }
+                }
+            }
+            if (empty)
+            {
+                error = keyword + " needs at least one key";
+                return false;
+            }
+        }
+        if (request.ops.empty())
+        {
+            error = "nothing to do";
+            return false;
+        }
+        return true;
+    }
+
+    void Generic_epsBackdoor::format(const Generic_epsBackdoorParam& param, double value, std::string& reply)
+    {
+        char buf[64];
+        typedef Generic_epsBackdoorParam P;
+
+        switch (param.field)
+        {
+            case P::STATUS:
+                std::snprintf(buf, sizeof(buf), "0x%04x", (unsigned)value);
+                break;
+            case P::STATE:
+            case P::OVERRIDE:
+            case P::VALUE:
+                std::snprintf(buf, sizeof(buf), "%.0f", value);
+                break;
+            case P::TEMPERATURE:
+                std::snprintf(buf, sizeof(buf), "%.2f", value);
+                break;
+            case P::WATTHRS:
+            case P::X:
+            case P::Y:
+            case P::Z:
+                std::snprintf(buf, sizeof(buf), "%.6f", value);
+                break;
+            default:
+                std::snprintf(buf, sizeof(buf), "%.3f", value);
+                break;
+        }
+        reply += " ";
+        reply += param.name;
+        reply += "=";
+        reply += buf;
+    }
+
+    bool Generic_epsBackdoor::in_range(const Generic_epsBackdoorParam& param, double value)
+    {
+        typedef Generic_epsBackdoorParam P;
+        double word;
+
+        if (!(value >= param.min) || !(value <= param.max))
+        {
+            return false;
+        }
+
+        /* The table's limits are the 16 bit limits, this catches rounding past them */
+        switch (param.field)
+        {
+            case P::VOLTAGE:
+            case P::CURRENT:     word = std::round(value * 1000.0); break;
+            case P::TEMPERATURE: word = std::round((value + 60.0) * 100.0); break;
+            case P::STATUS:      word = std::round(value); break;
+            default:             return true;
+        }
+        return (word >= 0.0) && (word <= 65535.0);
+    }
+
+    std::uint16_t Generic_epsBackdoor::to_word(Generic_epsBackdoorParam::Field field, double value)
+    {
+        typedef Generic_epsBackdoorParam P;
+        double word;
+
+        switch (field)
+        {
+            case P::VOLTAGE:
+            case P::CURRENT:     word = value * 1000.0; break;
+            case P::TEMPERATURE: word = (value + 60.0) * 100.0; break;
+            default:             word = value; break;
+        }
+        word = std::round(word);
+        return (std::uint16_t)((word < 0.0) ? 0.0 : ((word > 65535.0) ? 65535.0 : word));
+    }
+
+    /* Glob match with '*' only, patterns are a few characters against short keys */
+    bool Generic_epsBackdoor::match(const char* pattern, const char* name)
+    {
+        while (*pattern != '\0')
+        {
+            if (*pattern == '*')
+            {
+                do
+                {
+                    if (match(pattern + 1, name))
+                    {
+                        return true;
+                    }
+                } while (*name++ != '\0');
+                return false;
+            }
+            if (*pattern++ != *name++)
+            {
+                return false;
+            }
+        }
+        return *name == '\0';
+    }
+
+    bool Generic_epsBackdoor::parse_value(const std::string& text, double& value)
+    {
+        std::string lower = boost::to_lower_copy(text);
+        if ((lower == "on") || (lower == "true"))
+        {
+            value = 1.0;
+            return true;
+        }
+        if ((lower == "off") || (lower == "false"))
+        {
+            value = 0.0;
+            return true;
+        }
+
+        /* Whole string must be a finite number, hex such as 0x00AA is accepted for status words */
+        char* end;
+        value = std::strtod(text.c_str(), &end);
+        return !text.empty() && (*end == '\0') && std::isfinite(value);
+    }
+}
@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/foreach.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+#include <generic_eps_batch.hpp>
+
+namespace Nos3
+{
+    static bool event_before(const Generic_epsBatchEvent& a, const Generic_epsBatchEvent& b)
+    {
+        return a.tick < b.tick;
+    }
+
+    Generic_epsBatch::Generic_epsBatch(std::int64_t tick_us, double duration, bool event_integration) :
+        _tick_us(tick_us), _event_integration(event_integration)
+    {
+        _ticks = (std::uint64_t)std::llround(duration * 1000000.0 / tick_us);
+    }
+
+    bool Generic_epsBatch::load_config(const std::string& filename, boost::property_tree::ptree& config)
+    {
+        boost::property_tree::ptree file;
+
+        try
+        {
+            boost::property_tree::read_xml(filename, file, boost::property_tree::xml_parser::trim_whitespace);
+        }
+        catch (const boost::property_tree::xml_parser_error& e)
+        {
+            std::fprintf(stderr, "%s\n", e.what());
+            return false;
+        }
+
+        if (file.get_child_optional("simulator"))
+        {
+            config = file;
+            return true;
+        }
+
+        if (file.get_child_optional("nos3-configuration.simulators"))
+        {
+            BOOST_FOREACH(const boost::property_tree::ptree::value_type &v, file.get_child("nos3-configuration.simulators"))
+            {
+                if (v.second.get("hardware-model.type", "").compare("GENERIC_EPS") == 0)
+                {
+                    config.put_child("simulator", v.second);
+                    if (file.get_child_optional("nos3-configuration.common"))
+                    {
+                        config.put_child("common", file.get_child("nos3-configuration.common"));
+                    }
+                    return true;
+                }
+            }
+        }
+
+        std::fprintf(stderr, "%s: no GENERIC_EPS simulator found\n", filename.c_str());
+        return false;
+    }
+
+    bool Generic_epsBatch::load_schedule(const std::string& filename)
+    {
+        std::ifstream in(filename.c_str());
+        std::string line;
+        unsigned line_num = 0;
+
+        if (!in)
+        {
+            std::fprintf(stderr, "%s: unable to open\n", filename.c_str());
+            return false;
+        }
+
+        while (std::getline(in, line))
+        {
+            line_num++;
+            line = line.substr(0, line.find('#'));
+
+            std::istringstream fields(line);
+            double seconds;
+            std::string kind;
+            if (!(fields >> seconds))
+            {
+                continue; /* Blank or comment */
+            }
+            fields >> kind;
+            boost::to_upper(kind);
+
+            Generic_epsBatchEvent ev;
+            ev.tick = (std::uint64_t)std::llround(seconds * 1000000.0 / _tick_us);
+            ev.is_switch = (kind.compare("SWITCH") == 0);
+            ev.sw_num = 0;
+            ev.sw_status = 0;
+            ev.sun.x = ev.sun.y = ev.sun.z = 0.0;
+            ev.sun.valid = true;
+
+            bool ok = false;
+            if (ev.is_switch)
+            {
+                unsigned sw_num;
+                std::string status;
+                ok = (fields >> sw_num >> status) && (sw_num < GENERIC_EPS_POWER_MAX_SWITCHES);
+                if (ok)
+                {
+                    ev.sw_num = sw_num;
+                    ev.sw_status = std::strtoul(status.c_str(), NULL, 16);
+                }
+            }
+            else if (kind.compare("SUN") == 0)
+            {
+                ok = (bool)(fields >> ev.sun.x >> ev.sun.y >> ev.sun.z);
+            }
+
+            if (!ok || (seconds < 0))
+            {
+                std::fprintf(stderr, "%s:%u: expected <seconds> SWITCH <n> <hex status> or <seconds> SUN <x> <y> <z>\n", filename.c_str(), line_num);
+                return false;
+            }
+            _events.push_back(ev);
+        }
+
+        /* Same time events keep file order */
+        std::stable_sort(_events.begin(), _events.end(), event_before);
+        return true;
+    }
+
+    std::uint64_t Generic_epsBatch::ticks_below(std::int64_t start_pwh, std::int64_t delta_pwh, std::uint64_t ticks, std::int64_t threshold_pwh)
+    {
+        std::uint64_t above;
+
+        /* Tick k of 1..ticks ends at start_pwh + k * delta_pwh */
+        if (delta_pwh == 0)
+        {
+            return (start_pwh < threshold_pwh) ? ticks : 0;
+        }
+        if (delta_pwh > 0)
+        {
+            /* Below for k < (threshold - start) / delta */
+            if (start_pwh >= threshold_pwh)
+            {
+                return 0;
+            }
+            std::uint64_t below = (std::uint64_t)((threshold_pwh - start_pwh + delta_pwh - 1) / delta_pwh) - 1;
+            return (below < ticks) ? below : ticks;
+        }
+        /* Below for k > (start - threshold) / -delta */
+        if (start_pwh < threshold_pwh)
+        {
+            return ticks;
+        }
+        above = (std::uint64_t)((start_pwh - threshold_pwh) / -delta_pwh);
+        return (above < ticks) ? ticks - above : 0;
+    }
+
+    Generic_epsBatchResult Generic_epsBatch::run(Generic_epsPowerModel& power, double threshold_watthrs,
+        std::uint64_t every, std::vector<Generic_epsTraceRecord>* recs) const
+    {
+        Generic_epsBatchResult result;
+        Generic_epsSunVector sun = {0.0, 0.0, 0.0, true}; /* Zero until the first SUN event */
+        std::size_t next_event = 0;
+        double seconds = _tick_us / 1000000.0;
+        std::int64_t threshold_pwh = std::llround(threshold_watthrs * GENERIC_EPS_POWER_PWH_PER_WH);
+        std::uint64_t below_ticks = 0;
+        std::uint64_t tick = 0;
+
+        if (recs == nullptr)
+        {
+            every = 0;
+        }
+        result.min_watthrs = power.get_battery_watthrs();
+        result.min_time = 0.0;
+        if (every > 0)
+        {
+            recs->reserve(recs->size() + _ticks / every + 1);
+        }
+
+        while (tick < _ticks)
+        {
+            while ((next_event < _events.size()) && (_events[next_event].tick <= tick))
+            {
+                const Generic_epsBatchEvent& ev = _events[next_event++];
+                if (ev.is_switch)
+                {
+                    power.set_switch_status(ev.sw_num, ev.sw_status);
+                }
+                else
+                {
+                    sun = ev.sun;
+                }
+            }
+
+            /* Sun and load are constant up to the next event or record */
+            std::uint64_t next = _ticks;
+            if (!_event_integration)
+            {
+                next = tick + 1;
+            }
+            if ((next_event < _events.size()) && (_events[next_event].tick < next))
+            {
+                next = _events[next_event].tick;
+            }
+            if ((every > 0) && ((tick / every + 1) * every < next))
+            {
+                next = (tick / every + 1) * every;
+            }
+
+            std::uint64_t ticks = next - tick;
+            std::int64_t start_pwh = power.get_battery_pwh();
+            power.advance(seconds, sun, ticks);
+            std::int64_t delta_pwh = (power.get_battery_pwh() - start_pwh) / (std::int64_t)ticks;
+            tick = next;
+
+            /* Linear in between, so the minimum is at one end */
+            if (power.get_battery_watthrs() < result.min_watthrs)
+            {
+                result.min_watthrs = power.get_battery_watthrs();
+                result.min_time = tick * seconds;
+            }
+            below_ticks += ticks_below(start_pwh, delta_pwh, ticks, threshold_pwh);
+
+            if ((every > 0) && ((tick % every) == 0))
+            {
+                Generic_epsTraceRecord rec;
+                power.fill_trace_record(tick * seconds, rec);
+                recs->push_back(rec);
+            }
+        }
+
+        result.below_time = below_ticks * seconds;
+        result.final_watthrs = power.get_battery_watthrs();
+        return result;
+    }
+}
@@ -0,0 +1,78 @@
+#include <cstdio>
+#include <cstring>
+
+#include <generic_eps_checkpoint.hpp>
+
+namespace Nos3
+{
+    void Generic_epsCheckpoint::capture(const Generic_epsPowerModel& power, std::uint8_t enabled, std::uint8_t initialized_other_sims)
+    {
+        std::memset(&_hdr, 0, sizeof(_hdr));
+        std::memcpy(_hdr.magic, GENERIC_EPS_CHECKPOINT_MAGIC, sizeof(_hdr.magic));
+        _hdr.version = GENERIC_EPS_CHECKPOINT_VERSION;
+        _hdr.rail_size = sizeof(Generic_epsPowerModel::EPS_Rail);
+        _hdr.num_buses = GENERIC_EPS_POWER_NUM_BUSES;
+        _hdr.num_switches = power.get_num_switches();
+        _hdr.enabled = enabled;
+        _hdr.initialized_other_sims = initialized_other_sims;
+        _hdr.battery_pwh = power.get_battery_pwh();
+        _hdr.p_in = power.get_p_in();
+
+        std::memcpy(_bus, &power.get_bus(0), sizeof(_bus));
+        std::memcpy(_switch, power.get_switches(), _hdr.num_switches * sizeof(Generic_epsPowerModel::EPS_Rail));
+    }
+
+    bool Generic_epsCheckpoint::apply(Generic_epsPowerModel& power, std::uint8_t& enabled, std::uint8_t& initialized_other_sims) const
+    {
+        if (!power.restore(_bus, _switch, _hdr.num_switches, _hdr.battery_pwh, _hdr.p_in))
+        {
+            return false;
+        }
+        enabled = _hdr.enabled;
+        initialized_other_sims = _hdr.initialized_other_sims;
+        return true;
+    }
+
+    bool Generic_epsCheckpoint::write(const std::string& filename) const
+    {
+        std::FILE* fp;
+        bool ok;
+
+        fp = std::fopen(filename.c_str(), "wb");
+        if (fp == NULL)
+        {
+            return false;
+        }
+        ok = (std::fwrite(&_hdr, sizeof(_hdr), 1, fp) == 1) &&
+             (std::fwrite(_bus, sizeof(Generic_epsPowerModel::EPS_Rail), GENERIC_EPS_POWER_NUM_BUSES, fp) == GENERIC_EPS_POWER_NUM_BUSES);
+        if (ok && (_hdr.num_switches > 0))
+        {
+            ok = (std::fwrite(_switch, sizeof(Generic_epsPowerModel::EPS_Rail), _hdr.num_switches, fp) == _hdr.num_switches);
+        }
+        ok = (std::fclose(fp) == 0) && ok;
+
+        return ok;
+    }
+
+    bool Generic_epsCheckpoint::read(const std::string& filename)
+    {
+        std::FILE* fp;
+        bool ok;
+
+        fp = std::fopen(filename.c_str(), "rb");
+        if (fp == NULL)
+        {
+            return false;
+        }
+        ok = (std::fread(&_hdr, sizeof(_hdr), 1, fp) == 1) &&
+             (std::memcmp(_hdr.magic, GENERIC_EPS_CHECKPOINT_MAGIC, sizeof(_hdr.magic)) == 0) &&
+             (_hdr.version == GENERIC_EPS_CHECKPOINT_VERSION) &&
+             (_hdr.rail_size == sizeof(Generic_epsPowerModel::EPS_Rail)) &&
+             (_hdr.num_buses == GENERIC_EPS_POWER_NUM_BUSES) &&
+             (_hdr.num_switches <= GENERIC_EPS_POWER_MAX_SWITCHES) &&
+             (std::fread(_bus, sizeof(Generic_epsPowerModel::EPS_Rail), GENERIC_EPS_POWER_NUM_BUSES, fp) == GENERIC_EPS_POWER_NUM_BUSES) &&
+             (std::fread(_switch, sizeof(Generic_epsPowerModel::EPS_Rail), _hdr.num_switches, fp) == _hdr.num_switches);
+        std::fclose(fp);
+        return ok;
+    }
+}
@@ -0,0 +1,641 @@
+#include <cmath>
+#include <cstring>
+
+#include <boost/algorithm/string.hpp>
+
+#include <generic_eps_core.hpp>
+
+namespace Nos3
+{
+    extern ItcLogger::Logger *sim_logger;
+
+    Generic_epsCore::Generic_epsCore(const boost::property_tree::ptree& config, double absolute_start_time, std::int64_t microseconds_per_tick, SwitchNotify notify,
+        Generic_epsCoreFleet* fleet) :
+    _own_fleet((fleet == nullptr) ? new Generic_epsCoreFleet(microseconds_per_tick) : nullptr), _fleet((fleet == nullptr) ? *_own_fleet : *fleet),
+    _power(_fleet._power), _state_lock(_fleet._state_lock), _initial_power(config), _i2c_head(0), _i2c_tail(0), _i2c_refused(0),
+    _slot(_fleet.join(this, _initial_power)), _hk(_initial_power.get_num_switches()), _i2c_power(_initial_power), _i2c_hk(_initial_power.get_num_switches()), _notify(notify), _absolute_start_time(absolute_start_time),
+    _time(0), _enabled(GENERIC_EPS_SIM_SUCCESS), _initialized_other_sims(GENERIC_EPS_SIM_ERROR), _resets(0)
+    {
+        /* Binary trace of the power model, replaces per tick console output */
+        _trace.reset(new Generic_epsTrace(config.get("simulator.hardware-model.trace-depth", GENERIC_EPS_TRACE_DEFAULT_DEPTH)));
+
+        /* Tick integration steps the battery every tick, event integration only when the sun, a switch or a reader needs it */
+        std::string integration = config.get("simulator.hardware-model.integration", "tick");
+        _event_integration = (boost::to_upper_copy(integration).compare("EVENT") == 0);
+        _sun_tolerance = config.get("simulator.hardware-model.sun-tolerance", 0.0);
+        _pending_sun.x = _pending_sun.y = _pending_sun.z = 0.0;
+        _pending_sun.valid = false;
+        _pending_ticks = 0;
+        _sun_override = false;
+        _override_sun = _pending_sun;
+
+        /* Prepare the initial HK frame so the first request has data ready */
+        Generic_epsCoreFleet::Writer writer(_fleet);
+        publish_generic_eps_data();
+    }
+
+    void Generic_epsCore::set_switch_status(std::uint8_t sw_num, std::uint16_t sw_status)
+    {
+        if (_power.set_switch_status(_slot, sw_num, sw_status))
+        {
+            _hk.mark_switch_dirty(sw_num);
+        }
+    }
+
+    bool Generic_epsCore::save_checkpoint(const std::string& filename)
+    {
+        Generic_epsCheckpoint checkpoint;
+
+        /* Copy a consistent state under the lock, write it without holding up the tick */
+        {
+            Generic_epsCoreFleet::Writer writer(_fleet);
+            integrate_battery_values();
+            checkpoint.capture(get_model(), _enabled.load(std::memory_order_relaxed), _initialized_other_sims);
+        }
+        return checkpoint.write(filename);
+    }
+
+    bool Generic_epsCore::load_checkpoint(const std::string& filename)
+    {
+        Generic_epsCheckpoint checkpoint;
+
+        return checkpoint.read(filename) && apply_checkpoint(checkpoint);
+    }
+
+    bool Generic_epsCore::apply_checkpoint(const Generic_epsCheckpoint& checkpoint)
+    {
+        std::uint64_t changed, mask;
+        bool initialized;
+
+        {
+            Generic_epsCoreFleet::Writer writer(_fleet);
+            std::uint64_t before = _power.get_switch_mask(_slot);
+
+            /* Whether the other simulators have been powered is a fact of this run, not of the saved one */
+            Generic_epsPowerModel power(_initial_power);
+            std::uint8_t saved_enabled, saved_initialized;
+            if (!checkpoint.apply(power, saved_enabled, saved_initialized))
+            {
+                return false;
+            }
+            _power.restore(_slot, power);
+            _enabled.store(saved_enabled, std::memory_order_relaxed);
+            mask = _power.get_switch_mask(_slot);
+            changed = before ^ mask;
+            initialized = (_initialized_other_sims == GENERIC_EPS_SIM_SUCCESS);
+
+            /* Ticks before the load are dropped, the restored battery already has its history */
+            _pending_ticks = 0;
+            _hk.mark_all_dirty();
+            publish_generic_eps_data();
+        }
+
+        /* Powered simulators follow the restored switches */
+        notify_changed(changed, mask, initialized);
+        return true;
+    }
+
+    std::string Generic_epsCore::execute(const Generic_epsBackdoorRequest& request)
+    {
+        std::string reply = "OK";
+        std::uint64_t changed, mask;
+        bool initialized;
+
+        /* Nothing is applied unless every value fits, whether or not the request came through parse */
+        std::vector<Generic_epsBackdoorRequest::Op>::const_iterator op;
+        for (op = request.ops.begin(); op != request.ops.end(); ++op)
+        {
+            if (op->set && (!op->param->writable || !Generic_epsBackdoor::in_range(*op->param, op->value)))
+            {
+                return "ERROR " + op->param->name + (op->param->writable ? " out of range" : " is read only");
+            }
+        }
+
+        {
+            Generic_epsCoreFleet::Writer writer(_fleet);
+            std::uint64_t before = _power.get_switch_mask(_slot);
+
+            /* Ticks so far ran at the old load and sun, and reads see the battery as of now */
+            integrate_battery_values();
+
+            for (op = request.ops.begin(); op != request.ops.end(); ++op)
+            {
+                if (op->set)
+                {
+                    set_param(*op->param, op->value);
+                }
+                else
+                {
+                    Generic_epsBackdoor::format(*op->param, get_param(*op->param), reply);
+                }
+            }
+            mask = _power.get_switch_mask(_slot);
+            changed = before ^ mask;
+            initialized = (_initialized_other_sims == GENERIC_EPS_SIM_SUCCESS);
+            publish_generic_eps_data();
+        }
+
+        /* Switches turned on or off here power their simulators the same as an I2C command */
+        notify_changed(changed, mask, initialized);
+        return reply;
+    }
+
+    Generic_epsSunVector Generic_epsCore::get_sun(const Generic_epsSunVector& provided) const
+    {
+        Generic_epsSunVector sun;
+        bool held;
+        std::uint32_t seq;
+
+        do
+        {
+            seq = _state_lock.read_begin();
+            held = _sun_override;
+            sun = _override_sun;
+        } while (_state_lock.read_retry(seq));
+        return held ? sun : provided;
+    }
+
+    bool Generic_epsCore::get_ready(void) const
+    {
+        bool ready;
+        std::uint32_t seq;
+
+        do
+        {
+            seq = _state_lock.read_begin();
+            ready = (_initialized_other_sims == GENERIC_EPS_SIM_SUCCESS);
+        } while (_state_lock.read_retry(seq));
+        return ready;
+    }
+
+    double Generic_epsCore::get_param(const Generic_epsBackdoorParam& param) const
+    {
+        typedef Generic_epsBackdoorParam P;
+        const Generic_epsPowerModel::EPS_Rail& rail = (param.target == P::SWITCH) ? _power.get_switch(_slot)[param.index] : _power.get_bus(_slot)[param.index];
+
+        switch (param.target)
+        {
+            case P::BUS:
+            case P::SWITCH:
+                switch (param.field)
+                {
+                    case P::VOLTAGE:     return rail._voltage / 1000.0;
+                    case P::CURRENT:     return rail._current / 1000.0;
+                    case P::TEMPERATURE: return rail._temperature / 100.0 - 60.0;
+                    case P::STATUS:      return rail._status;
+                    case P::STATE:       return (_power.get_switch_mask(_slot) >> param.index) & 1;
+                    case P::WATTHRS:     return _power.get_battery_watthrs(_slot);
+                    default:             return 0.0;
+                }
+            case P::SUN:
+                switch (param.field)
+                {
+                    case P::X:        return _sun_override ? _override_sun.x : _pending_sun.x;
+                    case P::Y:        return _sun_override ? _override_sun.y : _pending_sun.y;
+                    case P::Z:        return _sun_override ? _override_sun.z : _pending_sun.z;
+                    case P::OVERRIDE: return _sun_override ? 1.0 : 0.0;
+                    default:          return 0.0;
+                }
+            case P::ENABLED:
+                return (_enabled.load(std::memory_order_relaxed) == GENERIC_EPS_SIM_SUCCESS) ? 1.0 : 0.0;
+            case P::TIME:
+                return (double)_time.load(std::memory_order_relaxed);
+            case P::READY:
+                return (_initialized_other_sims == GENERIC_EPS_SIM_SUCCESS) ? 1.0 : 0.0;
+            case P::RESETS:
+                return (double)_resets.load(std::memory_order_relaxed);
+            case P::POWER:
+                return (param.field == P::P_IN) ? _power.get_p_in(_slot) : _power.get_p_out(_slot);
+        }
+        return 0.0;
+    }
+
+    void Generic_epsCore::set_param(const Generic_epsBackdoorParam& param, double value)
+    {
+        typedef Generic_epsBackdoorParam P;
+
+        switch (param.target)
+        {
+            case P::BUS:
+            case P::SWITCH:
+            {
+                if (param.field == P::WATTHRS)
+                {
+                    _power.set_battery_watthrs(_slot, value);
+                    _hk.mark_dirty(GENERIC_EPS_SIM_SEG_BUS(0));
+                    break;
+                }
+                if (param.field == P::STATE)
+                {
+                    set_switch_status(param.index, (value != 0.0) ? 0x00AA : 0x0000);
+                    break;
+                }
+
+                /* Through a model of the slot, which keeps the load total and switch mask in step with the rail */
+                Generic_epsPowerModel power = get_model();
+                Generic_epsPowerModel::EPS_Rail rail = (param.target == P::SWITCH) ? power.get_switch(param.index) : power.get_bus(param.index);
+                switch (param.field)
+                {
+                    case P::VOLTAGE:     rail._voltage = Generic_epsBackdoor::to_word(param.field, value); break;
+                    case P::CURRENT:     rail._current = Generic_epsBackdoor::to_word(param.field, value); break;
+                    case P::TEMPERATURE: rail._temperature = Generic_epsBackdoor::to_word(param.field, value); break;
+                    case P::STATUS:      rail._status = Generic_epsBackdoor::to_word(param.field, value); break;
+                    default:             break;
+                }
+                if (param.target == P::SWITCH)
+                {
+                    power.set_switch(param.index, rail);
+                    _hk.mark_switch_dirty(param.index);
+                }
+                else
+                {
+                    power.set_bus(param.index, rail);
+                    _hk.mark_dirty(GENERIC_EPS_SIM_SEG_BUS(param.index));
+                }
+                _power.restore(_slot, power);
+                break;
+            }
+            case P::SUN:
+                /* A component starts from the sun in use, so one SET can hold the sun as it is */
+                if (!_sun_override)
+                {
+                    _override_sun = _pending_sun;
+                    _override_sun.valid = true;
+                }
+                switch (param.field)
+                {
+                    case P::X:        _override_sun.x = value; _sun_override = true; break;
+                    case P::Y:        _override_sun.y = value; _sun_override = true; break;
+                    case P::Z:        _override_sun.z = value; _sun_override = true; break;
+                    case P::OVERRIDE: _sun_override = (value != 0.0); break;
+                    default:          break;
+                }
+                break;
+            case P::ENABLED:
+                set_enabled(value != 0.0);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void Generic_epsCore::reset(void)
+    {
+        std::uint64_t changed, mask;
+        bool initialized;
+
+        {
+            Generic_epsCoreFleet::Writer writer(_fleet);
+            std::uint64_t before = _power.get_switch_mask(_slot);
+
+            _power.restore(_slot, _initial_power);
+            mask = _power.get_switch_mask(_slot);
+            changed = before ^ mask;
+            initialized = (_initialized_other_sims == GENERIC_EPS_SIM_SUCCESS);
+
+            /* Ticks since the last integration belong to the battery before the reset */
+            _pending_ticks = 0;
+            _resets.fetch_add(1, std::memory_order_relaxed);
+            _hk.mark_all_dirty();
+            publish_generic_eps_data();
+        }
+
+        /* Powered simulators follow the switches the reset turned on or off */
+        notify_changed(changed, mask, initialized);
+    }
+
+    /*
+    ** The one place switch changes reach other simulators.  Until the first tick has powered the simulators
+    ** on switches that are on, changes are not sent, that tick sends the mask as it stands then.
+    */
+    void Generic_epsCore::notify_changed(std::uint64_t changed, std::uint64_t mask, bool initialized)
+    {
+        std::uint8_t i;
+
+        if (!initialized)
+        {
+            return;
+        }
+
+        /* All at once, the notify only queues them */
+        for (i = 0; changed != 0; i++, changed >>= 1, mask >>= 1)
+        {
+            if (changed & 1)
+            {
+                _notify(i, (mask & 1) != 0);
+            }
+        }
+    }
+
+    /* Called after every state change with the state lock held, never from the I2C read path */
+    void Generic_epsCore::publish_generic_eps_data(void)
+    {
+        _hk.publish(_power.get_bus(_slot), _power.get_switch(_slot));
+    }
+
+    const char* Generic_epsCore::uint8_array_to_hex_string(const std::uint8_t* data, std::size_t len, char* str, std::size_t str_len)
+    {
+        static const char hex[] = "0123456789abcdef";
+        std::size_t i;
+        std::size_t pos = 0;
+
+        for (i = 0; (i < len) && (pos + 3 < str_len); i++)
+        {
+            str[pos++] = hex[data[i] >> 4];
+            str[pos++] = hex[data[i] & 0x0F];
+            str[pos++] = ' ';
+        }
+        if (str_len > 0)
+        {
+            str[(pos > 0) ? pos - 1 : 0] = '\0';
+        }
+        return str;
+    }
+
+    /* Protocol callback */
+    std::uint8_t Generic_epsCore::check_i2c_request(const std::uint8_t* in_data, std::size_t in_len, std::uint8_t num_switches)
+    {
+        std::uint8_t calc_crc8;
+
+        /* Check if message is incorrect size */
+        if (in_len != 3)
+        {
+            GENERIC_EPS_SIM_DEBUG("Generic_epsCore::check_i2c_request:  Invalid command size of %ld received!", in_len);
+            return GENERIC_EPS_SIM_ERROR;
+        }
+
+        /* Check CRC */
+        calc_crc8 = GENERIC_EPS_CRC8(in_data, 2);
+        if (in_data[2] != calc_crc8)
+        {
+            GENERIC_EPS_SIM_DEBUG("Generic_epsCore::check_i2c_request:  CRC8  of 0x%02x incorrect, expected 0x%02x!", in_data[2], calc_crc8);
+            return GENERIC_EPS_SIM_ERROR;
+        }
+
+        if ((in_data[0] < num_switches) && (!((in_data[1] == 0x00) || (in_data[1] == 0xAA))))
+        {
+            GENERIC_EPS_SIM_DEBUG("Generic_epsCore::check_i2c_request:  Set switch %d state of 0x%02x invalid!", in_data[0], in_data[1]);
+            return GENERIC_EPS_SIM_ERROR;
+        }
+        return GENERIC_EPS_SIM_SUCCESS;
+    }
+
+    std::uint8_t Generic_epsCore::determine_i2c_response_for_request(const std::uint8_t* in_data, std::size_t in_len, Generic_epsI2CResponse& out_data, std::size_t& out_len)
+    {
+        std::uint8_t valid = GENERIC_EPS_SIM_SUCCESS;
+        char hex_str[GENERIC_EPS_SIM_HEX_STR_LEN];
+
+        /* Nothing to read back unless a telemetry request fills it */
+        out_len = 0;
+
+        /* Retrieve data and log in man readable format */
+        GENERIC_EPS_SIM_DEBUG("Generic_epsCore::determine_i2c_response_for_request:  REQUEST %s",
+            uint8_array_to_hex_string(in_data, in_len, hex_str, sizeof(hex_str)));
+
+        /* Check simulator is enabled */
+        if (_enabled.load(std::memory_order_relaxed) != GENERIC_EPS_SIM_SUCCESS)
+        {
+            GENERIC_EPS_SIM_DEBUG("Generic_epsCore::determine_i2c_response_for_request:  Generic_eps sim disabled!");
+            valid = GENERIC_EPS_SIM_ERROR;
+        }
+        else
+        {
+            valid = check_i2c_request(in_data, in_len, get_num_switches());
+            if ((valid == GENERIC_EPS_SIM_SUCCESS) && (in_data[0] < get_num_switches()))
+            {
+                /* Command codes below the switch count set that switch */
+                GENERIC_EPS_SIM_DEBUG("Generic_epsCore::determine_i2c_response_for_request:  Set switch %d state to 0x%02x command received!", in_data[0], in_data[1]);
+                valid = queue_i2c_request(in_data[0], in_data[1]);
+            }
+            else if (valid == GENERIC_EPS_SIM_SUCCESS)
+            {
+                /* Process command */
+                switch (in_data[0])
+                {
+                    case 0x70:
+                        /* Telemetry Request */
+                        GENERIC_EPS_SIM_DEBUG("Generic_epsCore::determine_i2c_response_for_request:  Telemetry request command received!");
+
+                        /* Up to date with the pending ticks and queued requests, without writing the state */
+                        copy_hk(out_data.data());
+                        out_len = _hk.get_frame_len();
+                        break;
+
+                    case 0xAA:
+                        /* Reset */
+                        GENERIC_EPS_SIM_DEBUG("Generic_epsCore::determine_i2c_response_for_request:  Reset command received!");
+                        if (in_data[1] == 0xAA)
+                        {
+                            valid = queue_i2c_request(in_data[0], in_data[1]);
+                        }
+                        else
+                        {
+                            GENERIC_EPS_SIM_DEBUG("Generic_epsCore::determine_i2c_response_for_request:  Reset data of 0x%02x invalid! Expected 0xAA", in_data[1]);
+                            valid = GENERIC_EPS_SIM_ERROR;
+                        }
+                        break;
+
+                    default:
+                        /* Unused command code */
+                        GENERIC_EPS_SIM_DEBUG("Generic_epsCore::determine_i2c_response_for_request:  Unused command %d received!", in_data[0]);
+                        valid = GENERIC_EPS_SIM_ERROR;
+                        break;
+                }
+            }
+        }
+        return valid;
+    }
+
+    std::uint8_t Generic_epsCore::queue_i2c_request(std::uint8_t cmd, std::uint8_t data)
+    {
+        std::uint64_t head = _i2c_head.load(std::memory_order_relaxed);
+
+        /* Only if no tick or command has run for GENERIC_EPS_SIM_I2C_QUEUE requests */
+        if (head - _i2c_tail.load(std::memory_order_acquire) == _i2c_queue.size())
+        {
+            GENERIC_EPS_SIM_DEBUG("Generic_epsCore::queue_i2c_request:  Request 0x%02x refused, %d already queued!", cmd, GENERIC_EPS_SIM_I2C_QUEUE);
+            _i2c_refused.fetch_add(1, std::memory_order_relaxed);
+            return GENERIC_EPS_SIM_ERROR;
+        }
+
+        _i2c_queue[head % _i2c_queue.size()].cmd = cmd;
+        _i2c_queue[head % _i2c_queue.size()].data = data;
+        _i2c_head.store(head + 1, std::memory_order_release);
+        _fleet.post();
+        return GENERIC_EPS_SIM_SUCCESS;
+    }
+
+    void Generic_epsCore::copy_hk(std::uint8_t* out_data)
+    {
+        const std::uint64_t head = _i2c_head.load(std::memory_order_relaxed);
+        std::uint64_t tail, ticks;
+        Generic_epsSunVector sun;
+        std::uint32_t seq;
+
+        do
+        {
+            seq = _state_lock.read_begin();
+            tail = _i2c_tail.load(std::memory_order_relaxed);
+            ticks = _pending_ticks;
+            sun = _pending_sun;
+            if ((tail != head) || (ticks > 0))
+            {
+                _power.store(_slot, _i2c_power);
+            }
+        } while (_state_lock.read_retry(seq));
+
+        /* Frame was already encoded on the last tick or switch change, only copy it out */
+        if ((tail == head) && (ticks == 0))
+        {
+            _hk.copy(out_data);
+            return;
+        }
+
+        /* Otherwise the writer's steps on a copy: pending ticks at the old load, then the requests in order */
+        if (ticks > 0)
+        {
+            _i2c_power.advance(_fleet.get_seconds_per_tick(), sun, ticks);
+        }
+        for (; tail != head; tail++)
+        {
+            const I2CRequest& request = _i2c_queue[tail % _i2c_queue.size()];
+            if (request.cmd == 0xAA)
+            {
+                _i2c_power = _initial_power;
+            }
+            else
+            {
+                _i2c_power.set_switch_status(request.cmd, request.data);
+            }
+        }
+        _i2c_hk.mark_all_dirty();
+        _i2c_hk.publish(&_i2c_power.get_bus(0), _i2c_power.get_switches());
+        _i2c_hk.copy(out_data);
+    }
+
+    std::uint64_t Generic_epsCore::take_queued(void)
+    {
+        const std::uint64_t head = _i2c_head.load(std::memory_order_acquire);
+        std::uint64_t tail = _i2c_tail.load(std::memory_order_relaxed);
+        std::uint64_t before = _power.get_switch_mask(_slot);
+
+        if (tail == head)
+        {
+            return 0;
+        }
+
+        for (; tail != head; tail++)
+        {
+            const I2CRequest& request = _i2c_queue[tail % _i2c_queue.size()];
+            if (request.cmd == 0xAA)
+            {
+                /* Ticks since the last integration belong to the battery before the reset */
+                _power.restore(_slot, _initial_power);
+                _pending_ticks = 0;
+                _resets.fetch_add(1, std::memory_order_relaxed);
+                _hk.mark_all_dirty();
+            }
+            else
+            {
+                integrate_battery_values(); /* Ticks so far ran at the old load */
+                set_switch_status(request.cmd, request.data);
+            }
+        }
+        publish_generic_eps_data();
+
+        /* Inside the write section, so a reader sees the requests in the state or still queued, never both */
+        _i2c_tail.store(tail, std::memory_order_release);
+        return before ^ _power.get_switch_mask(_slot);
+    }
+
+    std::uint64_t Generic_epsCore::begin_tick(const Generic_epsSunVector& sun, std::uint64_t time, Generic_epsSunVector& step_sun, std::uint64_t& step_ticks)
+    {
+        std::uint64_t power_on = 0;
+
+        _time.store(time, std::memory_order_relaxed);
+
+        /* Simulators on switches that start on are powered on the first tick, the fleet notifies them after the step */
+        if (_initialized_other_sims == GENERIC_EPS_SIM_ERROR)
+        {
+            power_on = _power.get_switch_mask(_slot);
+            _initialized_other_sims = GENERIC_EPS_SIM_SUCCESS;
+        }
+
+        /* Battery is linear while the sun and load hold, integrate it when something changes */
+        if (_event_integration && (_pending_ticks > 0) &&
+            (std::fabs(sun.x - _pending_sun.x) <= _sun_tolerance) &&
+            (std::fabs(sun.y - _pending_sun.y) <= _sun_tolerance) &&
+            (std::fabs(sun.z - _pending_sun.z) <= _sun_tolerance))
+        {
+            _pending_ticks++;
+            step_ticks = 0;
+            return power_on;
+        }
+
+        /* Tick integration steps this tick, event integration the ticks run at the old sun */
+        step_sun = _event_integration ? _pending_sun : sun;
+        step_ticks = _event_integration ? _pending_ticks : 1;
+        _pending_sun = sun;
+        _pending_ticks = _event_integration ? 1 : 0;
+        return power_on;
+    }
+
+    void Generic_epsCore::end_step(bool changed)
+    {
+        if (changed)
+        {
+            _hk.mark_dirty(GENERIC_EPS_SIM_SEG_BUS(0));
+        }
+
+        /* Record the tick, decode a dump with generic_eps_trace_decode */
+        Generic_epsTraceRecord rec;
+        _power.fill_trace_record(_slot, _absolute_start_time + _time.load(std::memory_order_relaxed) * _fleet.get_seconds_per_tick(), rec);
+        _trace->record(rec);
+
+        publish_generic_eps_data();
+    }
+
+    void Generic_epsCore::integrate_battery_values(void)
+    {
+        if (_pending_ticks == 0)
+        {
+            return;
+        }
+
+        bool changed = _power.advance(_slot, _fleet.get_seconds_per_tick(), _pending_sun, _pending_ticks);
+        _pending_ticks = 0;
+        end_step(changed);
+    }
+
+    Generic_epsPowerModel Generic_epsCore::get_model(void) const
+    {
+        /* Built from the same config, so the slot always fits */
+        Generic_epsPowerModel power(_initial_power);
+        _power.store(_slot, power);
+        return power;
+    }
+
+    Generic_epsWriterStats Generic_epsCore::get_writer_stats(void) const
+    {
+        Generic_epsWriterStats stats;
+
+        stats.writes = _fleet.get_writes();
+        stats.handed_off = _fleet.get_handed_off();
+        stats.queued = _i2c_head.load(std::memory_order_relaxed);
+        stats.refused = _i2c_refused.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    Generic_epsPowerModel Generic_epsCore::get_power(void) const
+    {
+        Generic_epsPowerModel power(_initial_power);
+        std::uint32_t seq;
+
+        do
+        {
+            seq = _state_lock.read_begin();
+            _power.store(_slot, power);
+        } while (_state_lock.read_retry(seq));
+        return power;
+    }
+}
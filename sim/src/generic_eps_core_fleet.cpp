@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <thread>
+
+#include <generic_eps_core.hpp>
+
+namespace Nos3
+{
+    Generic_epsCoreFleet::Generic_epsCoreFleet(std::int64_t microseconds_per_tick) :
+    _seconds_per_tick(microseconds_per_tick / 1000000.0), _writer(false), _posted(0), _consumed(0),
+    _deferred_head(0), _deferred_tail(0), _handed_off(0)
+    {
+    }
+
+    void Generic_epsCoreFleet::reserve(std::size_t cores)
+    {
+        std::size_t i;
+
+        _power.reserve(cores, cores * GENERIC_EPS_POWER_MAX_SWITCHES);
+        _cores.reserve(cores);
+        _step_sun.reserve(cores);
+        _step_ticks.reserve(cores);
+        _changed.reserve(cores);
+        _power_on.reserve(cores);
+        _switched.reserve(cores);
+        for (i = 0; i < _deferred.size(); i++)
+        {
+            _deferred[i].sun.reserve(cores);
+        }
+    }
+
+    std::size_t Generic_epsCoreFleet::join(Generic_epsCore* core, const Generic_epsPowerModel& model)
+    {
+        Writer writer(*this);
+        Generic_epsSunVector dark = {0.0, 0.0, 0.0, false};
+        std::size_t i;
+
+        _cores.push_back(core);
+        _step_sun.push_back(dark);
+        _step_ticks.push_back(0);
+        _changed.push_back(0);
+        _power_on.push_back(0);
+        _switched.push_back(0);
+        for (i = 0; i < _deferred.size(); i++)
+        {
+            _deferred[i].sun.push_back(dark);
+        }
+        return _power.add(model);
+    }
+
+    void Generic_epsCoreFleet::tick(const Generic_epsSunVector* sun, std::uint64_t time)
+    {
+        /* Usual case, nobody else is writing */
+        if (!_writer.exchange(true))
+        {
+            run_posted();
+            run_tick(sun, time);
+            release();
+            return;
+        }
+
+        /* A command is writing, hand it the tick; only one holding the role for the whole ring makes the tick wait */
+        std::uint64_t head = _deferred_head.load(std::memory_order_relaxed);
+        while (head - _deferred_tail.load(std::memory_order_acquire) == _deferred.size())
+        {
+            if (!_writer.exchange(true))
+            {
+                run_posted();
+                release();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        DeferredTick& deferred = _deferred[head % _deferred.size()];
+        deferred.time = time;
+        std::copy(sun, sun + _cores.size(), deferred.sun.begin());
+        _deferred_head.store(head + 1, std::memory_order_release);
+        _handed_off.fetch_add(1, std::memory_order_relaxed);
+        _posted.fetch_add(1);
+
+        /* The command may have let go before it saw the tick */
+        run_while_posted();
+    }
+
+    void Generic_epsCoreFleet::apply_queued(void)
+    {
+        acquire();
+        run_posted();
+        release();
+    }
+
+    void Generic_epsCoreFleet::acquire(void)
+    {
+        while (_writer.exchange(true))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void Generic_epsCoreFleet::release(void)
+    {
+        _writer.store(false);
+        run_while_posted();
+    }
+
+    /* Whatever was posted after the holder last looked is run by whoever gets the role back first */
+    void Generic_epsCoreFleet::run_while_posted(void)
+    {
+        while ((_posted.load() != _consumed.load(std::memory_order_relaxed)) && !_writer.exchange(true))
+        {
+            run_posted();
+            _writer.store(false);
+        }
+    }
+
+    void Generic_epsCoreFleet::run_posted(void)
+    {
+        std::uint64_t posted = _posted.load();
+        std::uint64_t tail = _deferred_tail.load(std::memory_order_relaxed);
+
+        apply_i2c();
+        while (tail != _deferred_head.load(std::memory_order_acquire))
+        {
+            DeferredTick& deferred = _deferred[tail % _deferred.size()];
+            run_tick(deferred.sun.data(), deferred.time);
+            _deferred_tail.store(++tail, std::memory_order_release);
+        }
+        _consumed.store(posted, std::memory_order_relaxed);
+    }
+
+    void Generic_epsCoreFleet::apply_i2c(void)
+    {
+        const std::size_t count = _cores.size();
+        std::size_t n;
+
+        for (n = 0; n < count; n++)
+        {
+            if (_cores[n]->has_queued())
+            {
+                break;
+            }
+        }
+        if (n == count)
+        {
+            return;
+        }
+
+        {
+            Generic_epsSeqlockWriter writer(_state_lock);
+            for (n = 0; n < count; n++)
+            {
+                _switched[n] = _cores[n]->take_queued();
+            }
+        }
+
+        /* Set the state in other simulators */
+        for (n = 0; n < count; n++)
+        {
+            _cores[n]->notify_switched(_switched[n]);
+        }
+    }
+
+    void Generic_epsCoreFleet::run_tick(const Generic_epsSunVector* sun, std::uint64_t time)
+    {
+        const std::size_t count = _cores.size();
+        std::size_t n;
+
+        /* Requests sent before the tick apply at the load they were sent at */
+        apply_i2c();
+
+        {
+            /* Every core's rails, battery and published frame change together */
+            Generic_epsSeqlockWriter writer(_state_lock);
+
+            /* Each core decides how many ticks to integrate and at which sun, tick integration always one at this sun */
+            for (n = 0; n < count; n++)
+            {
+                _power_on[n] = _cores[n]->begin_tick(sun[n], time, _step_sun[n], _step_ticks[n]);
+            }
+
+            _power.step(_seconds_per_tick, _step_sun.data(), _step_ticks.data(), _changed.data());
+
+            for (n = 0; n < count; n++)
+            {
+                if (_step_ticks[n] > 0)
+                {
+                    _cores[n]->end_step(_changed[n] != 0);
+                }
+            }
+        }
+
+        /* Simulators on switches that start on are powered on the first tick, once every simulator is up */
+        for (n = 0; n < count; n++)
+        {
+            _cores[n]->notify_changed(_power_on[n], _power_on[n], true);
+        }
+    }
+}
@@ -1,3 +1,6 @@
+#include <cstdlib>
+#include <cstring>
+
 #include <ItcLogger/Logger.hpp>
 #include <generic_eps_data_point.hpp>
 
@@ -7,72 +10,75 @@ namespace Nos3
 
     Generic_epsDataPoint::Generic_epsDataPoint(double count)
     {
-        sim_logger->trace("Generic_epsDataPoint::Generic_epsDataPoint:  Defined Constructor executed");
+        GENERIC_EPS_SIM_TRACE("Generic_epsDataPoint::Generic_epsDataPoint:  Defined Constructor executed");
 
         /* Do calculations based on provided data */
-        _generic_eps_data_is_valid = true;
-        _sun_vector[0] = count * 0.001;
-        _sun_vector[1] = count * 0.002;
-        _sun_vector[2] = count * 0.003;
+        Generic_epsSunVector sun = sun_vector_from_count(count);
+        _generic_eps_data_is_valid = sun.valid;
+        _sun_vector[0] = sun.x;
+        _sun_vector[1] = sun.y;
+        _sun_vector[2] = sun.z;
+    }
+
+    Generic_epsDataPoint::Generic_epsDataPoint(const std::string& svb_prefix, const boost::shared_ptr<Sim42DataPoint> dp)
+    {
+        GENERIC_EPS_SIM_TRACE("Generic_epsDataPoint::Generic_epsDataPoint:  42 Constructor executed");
+
+        Generic_epsSunVector sun = parse_sun_vector(svb_prefix, dp);
+        _generic_eps_data_is_valid = sun.valid;
+        _sun_vector[0] = sun.x;
+        _sun_vector[1] = sun.y;
+        _sun_vector[2] = sun.z;
     }
 
-    Generic_epsDataPoint::Generic_epsDataPoint(int16_t spacecraft, const boost::shared_ptr<Sim42DataPoint> dp)
+    Generic_epsDataPoint::Generic_epsDataPoint(const Generic_epsSunVector& sun)
     {
-        sim_logger->trace("Generic_epsDataPoint::Generic_epsDataPoint:  42 Constructor executed");
+        GENERIC_EPS_SIM_TRACE("Generic_epsDataPoint::Generic_epsDataPoint:  Sun vector Constructor executed");
 
-        /* Initialize data */
-        _generic_eps_data_is_valid = false;
-        _sun_vector[0] = 0.0;
-        _sun_vector[1] = 0.0;
-        _sun_vector[2] = 0.0;
+        _generic_eps_data_is_valid = sun.valid;
+        _sun_vector[0] = sun.x;
+        _sun_vector[1] = sun.y;
+        _sun_vector[2] = sun.z;
+    }
 
-        /*
-        ** Declare 42 telemetry string prefix
-        ** 42 variables defined in `42/Include/42types.h`
-        ** 42 data stream defined in `42/Source/IPC/SimWriteToSocket.c`
-        */
-        std::ostringstream MatchString;
-        MatchString << "SC[" << spacecraft << "].svb = "; /* Sun-pointing unit vector, expressed in SC.B[0] [~=~] */
-        size_t MSsize = MatchString.str().size();
+    Generic_epsSunVector Generic_epsDataPoint::sun_vector_from_count(double count)
+    {
+        Generic_epsSunVector sun;
+        sun.valid = true;
+        sun.x = count * 0.001;
+        sun.y = count * 0.002;
+        sun.z = count * 0.003;
+        return sun;
+    }
 
-        /* Parse 42 telemetry */
-        std::vector<std::string> lines = dp->get_lines();
-        try 
+    Generic_epsSunVector Generic_epsDataPoint::parse_sun_vector(const std::string& svb_prefix, const boost::shared_ptr<Sim42DataPoint>& dp)
+    {
+        if (!dp)
         {
-            for (unsigned int i = 0; i < lines.size(); i++) 
+            Generic_epsSunVector sun = {0.0, 0.0, 0.0, false};
+            return sun;
+        }
+        return parse_sun_vector(svb_prefix, dp->get_lines());
+    }
+
+    void Generic_epsDataPoint::parse_sun_vectors(const boost::shared_ptr<Sim42DataPoint>& dp, std::vector<Generic_epsSunVector>& by_spacecraft)
+    {
+        if (!dp)
+        {
+            std::size_t i;
+            for (i = 0; i < by_spacecraft.size(); i++)
             {
-                /* Compare prefix */
-                if (lines[i].compare(0, MSsize, MatchString.str()) == 0) 
-                {
-                    size_t found = lines[i].find_first_of("=");
-                    /* Parse line */
-                    std::istringstream iss(lines[i].substr(found+1, lines[i].size()-found-1));
-                    /* Custom work to extract the data from the 42 string and save it off in the member data of this data point */
-                    std::string s;
-                    iss >> s;
-                    _sun_vector[0] = std::stod(s);
-                    iss >> s;
-                    _sun_vector[1] = std::stod(s);
-                    iss >> s;
-                    _sun_vector[2] = std::stod(s);
-                    /* Mark data as valid */
-                    _generic_eps_data_is_valid = true;
-                    /* Debug print */
-                    sim_logger->trace("Generic_epsDataPoint::Generic_epsDataPoint:  Parsed svb = %f %f %f", _sun_vector[0], _sun_vector[1], _sun_vector[2]);
-                }
+                by_spacecraft[i].valid = false;
             }
-        } 
-        catch(const std::exception& e) 
-        {
-            /* Report error */
-            sim_logger->error("Generic_epsDataPoint::Generic_epsDataPoint:  Parsing exception %s", e.what());
+            return;
         }
+        parse_sun_vectors(dp->get_lines(), by_spacecraft);
     }
 
     /* Used for printing a representation of the data point */
     std::string Generic_epsDataPoint::to_string(void) const
     {
-        sim_logger->trace("Generic_epsDataPoint::to_string:  Executed");
+        GENERIC_EPS_SIM_TRACE("Generic_epsDataPoint::to_string:  Executed");
         
         std::stringstream ss;
 
@@ -0,0 +1,142 @@
+#include <cstdlib>
+#include <cstring>
+
+#include <ItcLogger/Logger.hpp>
+#include <generic_eps_data_point.hpp>
+
+namespace Nos3
+{
+    extern ItcLogger::Logger *sim_logger;
+
+    Generic_epsSunVector Generic_epsDataPoint::parse_sun_vector(const std::string& svb_prefix, const std::vector<std::string>& lines)
+    {
+        /* Initialize data */
+        Generic_epsSunVector sun;
+        sun.valid = false;
+        sun.x = 0.0;
+        sun.y = 0.0;
+        sun.z = 0.0;
+
+        /*
+        ** Parse 42 telemetry in place, the svb prefix is built once by the provider
+        ** 42 variables defined in `42/Include/42types.h`
+        ** 42 data stream defined in `42/Source/IPC/SimWriteToSocket.c`
+        */
+        for (unsigned int i = 0; i < lines.size(); i++)
+        {
+            /* Compare prefix */
+            if (lines[i].compare(0, svb_prefix.size(), svb_prefix) == 0)
+            {
+                /* Parse line, the three components follow the prefix */
+                const char* field = lines[i].c_str() + svb_prefix.size();
+                double value[3];
+                char* end;
+                int j;
+                for (j = 0; j < 3; j++)
+                {
+                    value[j] = std::strtod(field, &end);
+                    if (end == field)
+                    {
+                        break;
+                    }
+                    field = end;
+                }
+
+                if (j == 3)
+                {
+                    /* Mark data as valid */
+                    sun.x = value[0];
+                    sun.y = value[1];
+                    sun.z = value[2];
+                    sun.valid = true;
+                    /* Debug print */
+                    GENERIC_EPS_SIM_TRACE("Generic_epsDataPoint::parse_sun_vector:  Parsed svb = %f %f %f", sun.x, sun.y, sun.z);
+                }
+                else
+                {
+                    /* Report error */
+                    sim_logger->error("Generic_epsDataPoint::parse_sun_vector:  Parsing error in %s", lines[i].c_str());
+                }
+
+                /* Only one svb line per spacecraft, stop scanning */
+                break;
+            }
+        }
+        return sun;
+    }
+
+    /* 42 writes TIME first, so this is normally the first line checked */
+    std::string Generic_epsDataPoint::frame_time(const std::vector<std::string>& lines)
+    {
+        static const char time_prefix[] = "TIME ";
+        std::size_t i;
+
+        for (i = 0; i < lines.size(); i++)
+        {
+            if (lines[i].compare(0, sizeof(time_prefix) - 1, time_prefix) == 0)
+            {
+                return lines[i].substr(sizeof(time_prefix) - 1);
+            }
+        }
+        return std::string();
+    }
+
+    /* Every SC[n].svb line in one pass, by_spacecraft is indexed by n and grows to fit */
+    void Generic_epsDataPoint::parse_sun_vectors(const std::vector<std::string>& lines, std::vector<Generic_epsSunVector>& by_spacecraft)
+    {
+        static const char sc_prefix[] = "SC[";
+        static const char svb_suffix[] = "].svb = ";
+        std::size_t i;
+
+        for (i = 0; i < by_spacecraft.size(); i++)
+        {
+            by_spacecraft[i].valid = false;
+        }
+
+        for (i = 0; i < lines.size(); i++)
+        {
+            if (lines[i].compare(0, sizeof(sc_prefix) - 1, sc_prefix) != 0)
+            {
+                continue;
+            }
+
+            /* Spacecraft number, then the svb name */
+            const char* field = lines[i].c_str() + sizeof(sc_prefix) - 1;
+            char* end;
+            long sc = std::strtol(field, &end, 10);
+            if ((end == field) || (sc < 0) || (std::strncmp(end, svb_suffix, sizeof(svb_suffix) - 1) != 0))
+            {
+                continue;
+            }
+            field = end + sizeof(svb_suffix) - 1;
+
+            double value[3];
+            int j;
+            for (j = 0; j < 3; j++)
+            {
+                value[j] = std::strtod(field, &end);
+                if (end == field)
+                {
+                    break;
+                }
+                field = end;
+            }
+            if (j != 3)
+            {
+                sim_logger->error("Generic_epsDataPoint::parse_sun_vectors:  Parsing error in %s", lines[i].c_str());
+                continue;
+            }
+
+            if ((std::size_t)sc >= by_spacecraft.size())
+            {
+                Generic_epsSunVector invalid = {0.0, 0.0, 0.0, false};
+                by_spacecraft.resize(sc + 1, invalid);
+            }
+            by_spacecraft[sc].x = value[0];
+            by_spacecraft[sc].y = value[1];
+            by_spacecraft[sc].z = value[2];
+            by_spacecraft[sc].valid = true;
+            GENERIC_EPS_SIM_TRACE("Generic_epsDataPoint::parse_sun_vectors:  Parsed SC[%ld].svb = %f %f %f", sc, value[0], value[1], value[2]);
+        }
+    }
+}
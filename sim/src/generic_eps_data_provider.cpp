@@ -8,13 +8,13 @@ namespace Nos3
 
     Generic_epsDataProvider::Generic_epsDataProvider(const boost::property_tree::ptree& config) : SimIDataProvider(config)
     {
-        sim_logger->trace("Generic_epsDataProvider::Generic_epsDataProvider:  Constructor executed");
+        GENERIC_EPS_SIM_TRACE("Generic_epsDataProvider::Generic_epsDataProvider:  Constructor executed");
         _request_count = 0;
     }
 
     boost::shared_ptr<SimIDataPoint> Generic_epsDataProvider::get_data_point(void) const
     {
-        sim_logger->trace("Generic_epsDataProvider::get_data_point:  Executed");
+        GENERIC_EPS_SIM_TRACE("Generic_epsDataProvider::get_data_point:  Executed");
 
         /* Prepare the provider data */
         _request_count++;
@@ -25,4 +25,13 @@ namespace Nos3
         /* Return the data point */
         return boost::shared_ptr<SimIDataPoint>(dp);
     }
+
+    Generic_epsSunVector Generic_epsDataProvider::get_sun_vector(void) const
+    {
+        GENERIC_EPS_SIM_TRACE("Generic_epsDataProvider::get_sun_vector:  Executed");
+
+        /* Same sequence as get_data_point, without the data point */
+        _request_count++;
+        return Generic_epsDataPoint::sun_vector_from_count(_request_count);
+    }
 }
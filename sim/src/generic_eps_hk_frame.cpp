@@ -0,0 +1,180 @@
+#include <cstring>
+
+#include <generic_eps_hk_frame.hpp>
+
+namespace Nos3
+{
+    Generic_epsHkFrame::Generic_epsHkFrame(std::uint8_t num_switches) : _gen(0)
+    {
+        std::uint8_t seg;
+
+        _num_switches = (num_switches > GENERIC_EPS_POWER_MAX_SWITCHES) ? GENERIC_EPS_POWER_MAX_SWITCHES : num_switches;
+        _num_segments = GENERIC_EPS_SIM_SEG_SWITCH(_num_switches + GENERIC_EPS_SIM_HK_SWITCH_GROUP - 1);
+        _frame_len = GENERIC_EPS_SIM_HK_FRAME_LEN(_num_switches);
+
+        /* Battery, 3.3V, 5.0V, 12V and EPS temperature, Solar Array, then the switch mask and switch groups, the last entry is the end of the telemetry data */
+        static const std::uint16_t bus_offset[GENERIC_EPS_SIM_SEG_MASK + 1] = {0, 4, 6, 8, 12, GENERIC_EPS_SIM_HK_HEADER_LEN};
+        for (seg = 0; seg <= GENERIC_EPS_SIM_SEG_MASK; seg++)
+        {
+            _segment_offset[seg] = bus_offset[seg];
+        }
+        for (seg = GENERIC_EPS_SIM_SEG_SWITCH(0); seg <= _num_segments; seg++)
+        {
+            _segment_offset[seg] = GENERIC_EPS_SIM_HK_HEADER_LEN + GENERIC_EPS_SIM_HK_MASK_LEN(_num_switches) +
+                4 * (seg - GENERIC_EPS_SIM_SEG_SWITCH(0)) * GENERIC_EPS_SIM_HK_SWITCH_GROUP;
+        }
+        _segment_offset[_num_segments] = GENERIC_EPS_SIM_HK_DATA_LEN(_num_switches);
+
+        /* Everything is encoded by the first publish */
+        std::memset(_encode, 0, sizeof(_encode));
+        std::memset(_frame, 0, sizeof(_frame));
+        _crc_state[0] = GENERIC_EPS_CRC8_INIT;
+        mark_all_dirty();
+    }
+
+    /* Custom function to prepare the Generic_eps Data, only dirty segments are re-encoded */
+    void Generic_epsHkFrame::encode(const Generic_epsPowerModel::EPS_Rail* bus, const Generic_epsPowerModel::EPS_Rail* sw)
+    {
+        std::uint8_t* out_data = _encode;
+        std::uint16_t dirty = _dirty.exchange(0, std::memory_order_relaxed);
+        std::uint8_t first = _num_segments;
+        std::uint8_t seg;
+        std::uint8_t crc;
+        std::uint8_t i;
+
+        for (seg = 0; seg < _num_segments; seg++)
+        {
+            if ((dirty & (1 << seg)) == 0)
+            {
+                continue;
+            }
+            if (first == _num_segments)
+            {
+                first = seg;
+            }
+
+            switch (seg)
+            {
+                case GENERIC_EPS_SIM_SEG_BUS(0):
+                    /* Battery  - Voltage */
+                    out_data[0] = (bus[0]._voltage >> 8) & 0x00FF;
+                    out_data[1] = bus[0]._voltage & 0x00FF;
+                    /* Battery  - Temperature */
+                    out_data[2] = (bus[0]._temperature >> 8) & 0x00FF;
+                    out_data[3] = bus[0]._temperature & 0x00FF;
+                    break;
+
+                case GENERIC_EPS_SIM_SEG_BUS(1):
+                    /* EPS      - 3.3 Voltage */
+                    out_data[4] = (bus[1]._voltage >> 8) & 0x00FF;
+                    out_data[5] = bus[1]._voltage & 0x00FF;
+                    break;
+
+                case GENERIC_EPS_SIM_SEG_BUS(2):
+                    /* EPS      - 5.0 Voltage */
+                    out_data[6] = (bus[2]._voltage >> 8) & 0x00FF;
+                    out_data[7] = bus[2]._voltage & 0x00FF;
+                    break;
+
+                case GENERIC_EPS_SIM_SEG_BUS(3):
+                    /* EPS      - 12.0 Voltage */
+                    out_data[8] = (bus[3]._voltage >> 8) & 0x00FF;
+                    out_data[9] = bus[3]._voltage & 0x00FF;
+                    /* EPS      - Temperature */
+                    out_data[10] = (bus[3]._voltage >> 8) & 0x00FF;
+                    out_data[11] = bus[3]._voltage & 0x00FF;
+                    break;
+
+                case GENERIC_EPS_SIM_SEG_BUS(4):
+                    /* Solar Array - Voltage */
+                    out_data[12] = (bus[4]._voltage >> 8) & 0x00FF;
+                    out_data[13] = bus[4]._voltage & 0x00FF;
+                    /* Solar Array - Temperature */
+                    out_data[14] = (bus[4]._temperature >> 8) & 0x00FF;
+                    out_data[15] = bus[4]._temperature & 0x00FF;
+                    break;
+
+                case GENERIC_EPS_SIM_SEG_MASK:
+                    /* Switch on bits, switch i in bit i % 8 of byte i / 8 */
+                    std::memset(&out_data[GENERIC_EPS_SIM_HK_HEADER_LEN], 0, GENERIC_EPS_SIM_HK_MASK_LEN(_num_switches));
+                    for (i = 0; i < _num_switches; i++)
+                    {
+                        if ((sw[i]._status & 0x00FF) == 0x00AA)
+                        {
+                            out_data[GENERIC_EPS_SIM_HK_HEADER_LEN + i / 8] |= (std::uint8_t)(1 << (i % 8));
+                        }
+                    }
+                    break;
+
+                default:
+                {
+                    std::uint8_t last = (seg - GENERIC_EPS_SIM_SEG_SWITCH(0) + 1) * GENERIC_EPS_SIM_HK_SWITCH_GROUP;
+                    std::uint16_t offset = _segment_offset[seg];
+                    for (i = last - GENERIC_EPS_SIM_HK_SWITCH_GROUP; (i < last) && (i < _num_switches); i++, offset += 4)
+                    {
+                        if ((sw[i]._status & 0x00FF) == 0x00AA)
+                        {
+                            /* Switch[i], ON - Voltage */
+                            out_data[offset] = (sw[i]._voltage >> 8) & 0x00FF;
+                            out_data[offset+1] = sw[i]._voltage & 0x00FF;
+                            /* Switch[i], ON - Current */
+                            out_data[offset+2] = (sw[i]._current >> 8) & 0x00FF;
+                            out_data[offset+3] = sw[i]._current & 0x00FF;
+                        }
+                        else
+                        {
+                            /* Switch[i], OFF - Voltage and Current */
+                            out_data[offset] = 0x00;
+                            out_data[offset+1] = 0x00;
+                            out_data[offset+2] = 0x00;
+                            out_data[offset+3] = 0x00;
+                        }
+                    }
+                    break;
+                }
+            }
+        }
+
+        /* CRC, resumed from the saved state at the first changed segment */
+        if (first < _num_segments)
+        {
+            crc = _crc_state[first];
+            for (seg = first; seg < _num_segments; seg++)
+            {
+                _crc_state[seg] = crc;
+                crc = GENERIC_EPS_CRC8_Update(crc, &out_data[_segment_offset[seg]],
+                    _segment_offset[seg + 1] - _segment_offset[seg]);
+            }
+            out_data[_segment_offset[_num_segments]] = crc;
+        }
+    }
+
+    /* Called after every state change, never from the I2C read path */
+    void Generic_epsHkFrame::publish(const Generic_epsPowerModel::EPS_Rail* bus, const Generic_epsPowerModel::EPS_Rail* sw)
+    {
+        std::uint32_t gen;
+
+        if (_dirty.load(std::memory_order_relaxed) == 0)
+        {
+            return;
+        }
+        encode(bus, sw);
+
+        gen = _gen.load(std::memory_order_relaxed) + 1;
+        std::memcpy(_frame[gen & 1], _encode, _frame_len);
+        _gen.store(gen, std::memory_order_release);
+    }
+
+    void Generic_epsHkFrame::copy(std::uint8_t* out_data) const
+    {
+        std::uint32_t gen;
+
+        /* Retry if a publish landed while copying, the frame is then from a single state */
+        do
+        {
+            gen = _gen.load(std::memory_order_acquire);
+            std::memcpy(out_data, _frame[gen & 1], _frame_len);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while (_gen.load(std::memory_order_relaxed) != gen);
+    }
+}
@@ -0,0 +1,283 @@
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <mutex>
+
+#include <boost/algorithm/string.hpp>
+
+#include <ItcLogger/Logger.hpp>
+#include <generic_eps_i2c_device.hpp>
+
+namespace Nos3
+{
+    extern ItcLogger::Logger *sim_logger;
+
+    Generic_epsI2CDevice::Generic_epsI2CDevice(const boost::property_tree::ptree& config, double absolute_start_time, std::int64_t microseconds_per_tick,
+        Generic_epsSwitchFanout& fanout, const std::string& connection_string, const std::string& bus_name, int bus_address,
+        Generic_epsCoreFleet* fleet) :
+    _fanout(fanout),
+    _core(config, absolute_start_time, microseconds_per_tick,
+        std::bind(&Generic_epsI2CDevice::notify_switch, this, std::placeholders::_1, std::placeholders::_2), fleet),
+    _backdoor(_core.get_num_switches()), _i2c_slave_connection(nullptr)
+    {
+        /* Node to notify for each switch, the power model reads the rest of the physical config */
+        Generic_epsPowerModel power = _core.get_power();
+        std::uint8_t i;
+        _switch_node_name.resize(power.get_num_switches());
+        for (i = 0; i < power.get_num_switches(); i++)
+        {
+            _switch_node_name[i] = config.get("simulator.hardware-model.physical.switch-" + std::to_string(i) + ".node-name", "switch-" + std::to_string(i));
+        }
+
+        /* Record I2C traffic from the start so a replay begins from the configured state */
+        std::string i2c_log_file = config.get("simulator.hardware-model.i2c-log", "");
+        if (!i2c_log_file.empty())
+        {
+            _i2c_log.reset(new Generic_epsI2CLog());
+            if (_i2c_log->open(i2c_log_file, _core.get_num_switches(), microseconds_per_tick, absolute_start_time))
+            {
+                sim_logger->info("Generic_epsI2CDevice::Generic_epsI2CDevice:  Recording I2C traffic to %s.", i2c_log_file.c_str());
+            }
+            else
+            {
+                sim_logger->error("Generic_epsI2CDevice::Generic_epsI2CDevice:  Unable to write I2C log %s.", i2c_log_file.c_str());
+                _i2c_log.reset();
+            }
+        }
+
+        /* Bus clock in kHz like GENERIC_EPS_CFG_I2C_SPEED, zero answers as fast as NOS Engine delivers */
+        double bus_khz = config.get("simulator.hardware-model.i2c-timing.bus-khz", 0.0);
+        double conversion_us = config.get("simulator.hardware-model.i2c-timing.conversion-microseconds", 0.0);
+        if (bus_khz > 0.0)
+        {
+            _i2c_timing.reset(new Generic_epsI2CTiming(bus_khz, conversion_us));
+            sim_logger->info("Generic_epsI2CDevice::Generic_epsI2CDevice:  I2C timing at %g kHz with %g us conversion.", bus_khz, conversion_us);
+        }
+
+        _trace_file = config.get("simulator.hardware-model.trace-file", "");
+
+        sim_logger->info("Generic_epsI2CDevice::Generic_epsI2CDevice:  %d switches, %d byte HK frame.", power.get_num_switches(), _core.get_frame_len());
+        if (power.get_num_switches() > 0)
+        {
+            sim_logger->info("    _switch[0]._voltage = %d", power.get_switch(0)._voltage);
+            sim_logger->info("    _switch[0]._current = %d", power.get_switch(0)._current);
+            sim_logger->info("    _switch[0]._status = 0x%04x", power.get_switch(0)._status);
+        }
+        sim_logger->info("Generic_epsI2CDevice::Generic_epsI2CDevice:  %s integration, sun tolerance %g.",
+            _core.get_event_integration() ? "Event" : "Tick", _core.get_sun_tolerance());
+
+        /* Get on the protocol bus last, once a request can be answered */
+        _i2c_slave_connection = new I2CSlaveConnection(&_core, bus_address, connection_string, bus_name, _i2c_log.get(), _i2c_timing.get());
+        sim_logger->info("Generic_epsI2CDevice::Generic_epsI2CDevice:  Now on I2C bus name %s as address 0x%02x.", bus_name.c_str(), bus_address);
+    }
+
+    Generic_epsI2CDevice::~Generic_epsI2CDevice(void)
+    {
+        close();
+
+        /* Flush what is left of the I2C log */
+        _i2c_log.reset();
+    }
+
+    void Generic_epsI2CDevice::close(void)
+    {
+        if (_i2c_slave_connection == nullptr)
+        {
+            return;
+        }
+
+        /* Close the protocol bus */
+        delete _i2c_slave_connection;
+        _i2c_slave_connection = nullptr;
+
+        /* Keep the power model trace if configured */
+        if (!_trace_file.empty())
+        {
+            std::int64_t count = _core.dump_trace(_trace_file);
+            sim_logger->info("Generic_epsI2CDevice::close:  Wrote %lld trace records to %s.", (long long)count, _trace_file.c_str());
+        }
+    }
+
+    void Generic_epsI2CDevice::notify_switch(std::uint8_t sw_num, bool on)
+    {
+        _fanout.post(_switch_node_name[sw_num], on);
+    }
+
+    void Generic_epsI2CDevice::tick(const Generic_epsSunVector& provided, std::uint64_t time)
+    {
+        /* A sun held through the backdoor replaces the provider's, and is what the I2C log records */
+        Generic_epsSunVector sun = _core.get_sun(provided);
+        std::unique_lock<std::mutex> lock = record_sun(sun, time);
+
+        _core.tick(sun, time);
+    }
+
+    std::unique_lock<std::mutex> Generic_epsI2CDevice::record_sun(const Generic_epsSunVector& sun, std::uint64_t time)
+    {
+        if (!_i2c_log)
+        {
+            return std::unique_lock<std::mutex>();
+        }
+
+        std::unique_lock<std::mutex> lock(_i2c_log->get_mutex());
+        _i2c_log->record_sun(time, sun);
+        return lock;
+    }
+
+    bool Generic_epsI2CDevice::command(const std::string& command, const std::string& argument, const std::string& prefix, std::string& response)
+    {
+        if (Generic_epsBackdoor::is_request(command))
+        {
+            /* Keys are matched in lower case, scripts get OK or ERROR back with no prefix */
+            Generic_epsBackdoorRequest request;
+            std::string error;
+            response = _backdoor.parse(command, request, error) ? _core.execute(request) : "ERROR " + error;
+        }
+        else if (command.compare("ENABLE") == 0)
+        {
+            _core.set_enabled(true);
+            response = prefix + "Enabled";
+        }
+        else if (command.compare("DISABLE") == 0)
+        {
+            _core.set_enabled(false);
+            response = prefix + "Disabled";
+        }
+        else if (command.compare(0, 6, "TRACE=") == 0)
+        {
+            std::int64_t count = _core.dump_trace(argument);
+            if (count >= 0)
+            {
+                response = prefix + "Wrote " + std::to_string(count) + " trace records to " + argument;
+            }
+            else
+            {
+                response = prefix + "Unable to write trace to " + argument;
+            }
+        }
+        else if (command.compare(0, 5, "SAVE=") == 0)
+        {
+            if (_core.save_checkpoint(argument))
+            {
+                response = prefix + "Saved state to " + argument;
+            }
+            else
+            {
+                response = prefix + "Unable to save state to " + argument;
+            }
+        }
+        else if (command.compare(0, 5, "LOAD=") == 0)
+        {
+            if (_core.load_checkpoint(argument))
+            {
+                response = prefix + "Loaded state from " + argument;
+            }
+            else
+            {
+                response = prefix + "Unable to load state from " + argument + " (missing, invalid or different switch count)";
+            }
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    std::string Generic_epsI2CDevice::get_stats(void) const
+    {
+        Generic_epsWriterStats writer = _core.get_writer_stats();
+        std::string stats = "resets " + std::to_string(_core.get_resets()) +
+            ", state writes " + std::to_string(writer.writes) + ", ticks handed off " + std::to_string(writer.handed_off) +
+            ", I2C requests queued " + std::to_string(writer.queued) + ", refused " + std::to_string(writer.refused);
+        if (_i2c_timing)
+        {
+            std::int64_t margin = _i2c_timing->get_min_margin_ns();
+            stats += ", I2C transactions " + std::to_string(_i2c_timing->get_transactions()) +
+                ", busy " + std::to_string(_i2c_timing->get_busy()) +
+                ", tightest margin " + ((margin == std::numeric_limits<std::int64_t>::max()) ? std::string("none") : std::to_string(margin / 1000) + " us");
+        }
+        return stats;
+    }
+
+    I2CSlaveConnection::I2CSlaveConnection(Generic_epsCore* core,
+        int bus_address, std::string connection_string, std::string bus_name, Generic_epsI2CLog* log, Generic_epsI2CTiming* timing)
+        : NosEngine::I2C::I2CSlave(bus_address, connection_string, bus_name)
+    {
+        _core = core;
+        _log = log;
+        _timing = timing;
+        _i2c_write_accepted = false;
+        _i2c_write_busy = false;
+        _i2c_read_valid = GENERIC_EPS_SIM_ERROR;
+        _i2c_out_len = 0;
+    }
+
+    size_t I2CSlaveConnection::i2c_read(uint8_t *rbuf, size_t rlen)
+    {
+        size_t num_read;
+        char hex_str[GENERIC_EPS_SIM_HEX_STR_LEN];
+        bool follows_write = _i2c_write_accepted;
+        bool busy = _i2c_write_busy;
+        _i2c_write_accepted = false;
+        _i2c_write_busy = false;
+        if ((_timing != nullptr) && (busy || !_timing->begin_read(Generic_epsI2CTiming::now_ns(), rlen, follows_write)))
+        {
+            /* Not acknowledged, the master sees the bus idle high */
+            std::memset(rbuf, 0xFF, rlen);
+            num_read = rlen;
+            GENERIC_EPS_SIM_DEBUG("i2c_read[%ld]: Busy (0xFF)", num_read);
+        }
+        else if(_i2c_read_valid == GENERIC_EPS_SIM_SUCCESS)
+        {
+            /* Bytes past the end of the response read as zeros, the master always gets rlen defined bytes */
+            num_read = (rlen < _i2c_out_len) ? rlen : _i2c_out_len;
+            std::memcpy(rbuf, _i2c_out_data.data(), num_read);
+            std::memset(rbuf + num_read, 0x00, rlen - num_read);
+            GENERIC_EPS_SIM_DEBUG("i2c_read[%ld of %ld]: %s", num_read, rlen,
+                Generic_epsCore::uint8_array_to_hex_string(rbuf, num_read, hex_str, sizeof(hex_str)));
+            num_read = rlen;
+        }
+        else
+        {
+            for(num_read = 0; num_read < rlen; num_read++)
+            {
+                rbuf[num_read] = 0x00;
+            }
+            GENERIC_EPS_SIM_DEBUG("i2c_read[%ld]: Invalid (0x00)", num_read);
+        }
+
+        return num_read;
+    }
+
+    size_t I2CSlaveConnection::i2c_write(const uint8_t *wbuf, size_t wlen)
+    {
+        char hex_str[GENERIC_EPS_SIM_HEX_STR_LEN];
+        GENERIC_EPS_SIM_DEBUG("i2c_write: %s",
+            Generic_epsCore::uint8_array_to_hex_string(wbuf, wlen, hex_str, sizeof(hex_str))); // log data
+
+        /* Too soon after the last transaction, the device never sees the write */
+        _i2c_write_accepted = false;
+        _i2c_write_busy = false;
+        if ((_timing != nullptr) && !_timing->begin_write(Generic_epsI2CTiming::now_ns(), wlen))
+        {
+            _i2c_write_busy = true;
+            GENERIC_EPS_SIM_DEBUG("i2c_write: Busy, not acknowledged");
+            return 0;
+        }
+        _i2c_write_accepted = true;
+
+        if (_log != nullptr)
+        {
+            /* Response and record together so the log order matches what the model saw */
+            std::lock_guard<std::mutex> lock(_log->get_mutex());
+            _i2c_read_valid = _core->determine_i2c_response_for_request(wbuf, wlen, _i2c_out_data, _i2c_out_len);
+            _log->record_i2c(_core->get_time(), wbuf, wlen, _i2c_read_valid, _i2c_out_data.data(), _i2c_out_len);
+        }
+        else
+        {
+            _i2c_read_valid = _core->determine_i2c_response_for_request(wbuf, wlen, _i2c_out_data, _i2c_out_len);
+        }
+        return wlen;
+    }
+}
@@ -0,0 +1,128 @@
+#include <chrono>
+#include <cstring>
+
+#include <generic_eps_i2c_log.hpp>
+
+/* Buffered writes reach the file at least this often so a crashed run keeps its traffic */
+#define GENERIC_EPS_I2C_LOG_FLUSH_NS    1000000000LL
+
+namespace Nos3
+{
+    static std::int64_t wall_clock_ns(void)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    Generic_epsI2CLog::Generic_epsI2CLog(void) : _fp(NULL), _have_sun(false), _last_flush_ns(0)
+    {
+        std::memset(&_last_sun, 0, sizeof(_last_sun));
+    }
+
+    Generic_epsI2CLog::~Generic_epsI2CLog(void)
+    {
+        close();
+    }
+
+    bool Generic_epsI2CLog::open(const std::string& filename, std::uint8_t num_switches, std::int64_t microseconds_per_tick, double start_time)
+    {
+        Generic_epsI2CLogHeader hdr;
+
+        close();
+        _fp = std::fopen(filename.c_str(), "wb");
+        if (_fp == NULL)
+        {
+            return false;
+        }
+
+        std::memset(&hdr, 0, sizeof(hdr));
+        std::memcpy(hdr.magic, GENERIC_EPS_I2C_LOG_MAGIC, sizeof(hdr.magic));
+        hdr.version = GENERIC_EPS_I2C_LOG_VERSION;
+        hdr.record_size = sizeof(Generic_epsI2CLogRecord);
+        hdr.num_switches = num_switches;
+        hdr.microseconds_per_tick = microseconds_per_tick;
+        hdr.start_time = start_time;
+        if (std::fwrite(&hdr, sizeof(hdr), 1, _fp) != 1)
+        {
+            close();
+            return false;
+        }
+        _have_sun = false;
+        _last_flush_ns = wall_clock_ns();
+        return true;
+    }
+
+    void Generic_epsI2CLog::close(void)
+    {
+        if (_fp != NULL)
+        {
+            std::fclose(_fp);
+            _fp = NULL;
+        }
+    }
+
+    void Generic_epsI2CLog::record_i2c(std::uint64_t tick, const std::uint8_t* wbuf, std::size_t wlen, std::uint8_t valid, const std::uint8_t* rbuf, std::size_t rlen)
+    {
+        Generic_epsI2CLogRecord rec;
+
+        std::memset(&rec, 0, sizeof(rec));
+        rec.tick = tick;
+        rec.type = GENERIC_EPS_I2C_LOG_TYPE_I2C;
+        rec.valid = valid;
+        rec.write_len = (std::uint16_t)wlen;
+        rec.read_len = (std::uint16_t)rlen;
+        append(rec, wbuf, wlen, rbuf, rlen);
+    }
+
+    void Generic_epsI2CLog::record_sun(std::uint64_t tick, const Generic_epsSunVector& sun)
+    {
+        Generic_epsI2CLogRecord rec;
+        Generic_epsI2CLogSun payload;
+
+        std::memset(&payload, 0, sizeof(payload));
+        payload.x = sun.x;
+        payload.y = sun.y;
+        payload.z = sun.z;
+        payload.valid = sun.valid ? 1 : 0;
+        if (_have_sun && (std::memcmp(&payload, &_last_sun, sizeof(payload)) == 0))
+        {
+            return;
+        }
+        _last_sun = payload;
+        _have_sun = true;
+
+        std::memset(&rec, 0, sizeof(rec));
+        rec.tick = tick;
+        rec.type = GENERIC_EPS_I2C_LOG_TYPE_SUN;
+        rec.read_len = sizeof(payload);
+        append(rec, NULL, 0, &payload, sizeof(payload));
+    }
+
+    void Generic_epsI2CLog::append(const Generic_epsI2CLogRecord& rec, const void* a, std::size_t a_len, const void* b, std::size_t b_len)
+    {
+        static const std::uint8_t pad[8] = {0};
+        Generic_epsI2CLogRecord stamped = rec;
+
+        if (_fp == NULL)
+        {
+            return;
+        }
+        stamped.wall_ns = wall_clock_ns();
+
+        std::fwrite(&stamped, sizeof(stamped), 1, _fp);
+        if (a_len > 0)
+        {
+            std::fwrite(a, 1, a_len, _fp);
+        }
+        if (b_len > 0)
+        {
+            std::fwrite(b, 1, b_len, _fp);
+        }
+        std::fwrite(pad, 1, GENERIC_EPS_I2C_LOG_ALIGN(a_len + b_len) - (a_len + b_len), _fp);
+
+        if (stamped.wall_ns - _last_flush_ns >= GENERIC_EPS_I2C_LOG_FLUSH_NS)
+        {
+            std::fflush(_fp);
+            _last_flush_ns = stamped.wall_ns;
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#include <generic_eps_i2c_timing.hpp>
+
+namespace Nos3
+{
+    Generic_epsI2CTiming::Generic_epsI2CTiming(double bus_khz, double conversion_us) :
+    _ns_per_byte((bus_khz > 0.0) ? std::llround(GENERIC_EPS_I2C_TIMING_BITS_PER_BYTE * 1000000.0 / bus_khz) : 0),
+    _conversion_ns((conversion_us > 0.0) ? std::llround(conversion_us * 1000.0) : 0),
+    _busy_until_ns(std::numeric_limits<std::int64_t>::min()), _transactions(0), _busy(0),
+    _min_margin_ns(std::numeric_limits<std::int64_t>::max())
+    {
+    }
+
+    bool Generic_epsI2CTiming::begin_write(std::int64_t now_ns, std::size_t wlen)
+    {
+        if (!begin(now_ns, wlen))
+        {
+            return false;
+        }
+
+        /* Conversion runs after the write, the read in the same transaction is answered at once and only moves the deadline */
+        _busy_until_ns += _conversion_ns;
+        return true;
+    }
+
+    bool Generic_epsI2CTiming::begin_read(std::int64_t now_ns, std::size_t rlen, bool follows_write)
+    {
+        if (!is_enabled())
+        {
+            return true;
+        }
+        if (follows_write)
+        {
+            /* Repeated start, address and data bytes on top of the write */
+            _busy_until_ns += (std::int64_t)(1 + rlen) * _ns_per_byte;
+            return true;
+        }
+        return begin(now_ns, rlen);
+    }
+
+    bool Generic_epsI2CTiming::begin(std::int64_t now_ns, std::size_t len)
+    {
+        if (!is_enabled())
+        {
+            return true;
+        }
+
+        _transactions.fetch_add(1, std::memory_order_relaxed);
+        if (_busy_until_ns != std::numeric_limits<std::int64_t>::min())
+        {
+            std::int64_t margin = now_ns - _busy_until_ns;
+            if (margin < _min_margin_ns.load(std::memory_order_relaxed))
+            {
+                _min_margin_ns.store(margin, std::memory_order_relaxed);
+            }
+            if (margin < 0)
+            {
+                /* Busy, the deadline stays where it was */
+                _busy.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        /* Address byte and data bytes */
+        _busy_until_ns = now_ns + (std::int64_t)(1 + len) * _ns_per_byte;
+        return true;
+    }
+
+    std::int64_t Generic_epsI2CTiming::now_ns(void)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
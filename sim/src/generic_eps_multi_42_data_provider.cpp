@@ -0,0 +1,59 @@
+#include <generic_eps_multi_42_data_provider.hpp>
+
+namespace Nos3
+{
+    REGISTER_DATA_PROVIDER(Generic_epsMulti42DataProvider,"GENERIC_EPS_MULTI_42_PROVIDER");
+
+    extern ItcLogger::Logger *sim_logger;
+
+    Generic_epsMulti42DataProvider::Generic_epsMulti42DataProvider(const boost::property_tree::ptree& config) : SimData42SocketProvider(config),
+        _cache_hits(0), _cache_misses(0)
+    {
+        GENERIC_EPS_SIM_TRACE("Generic_epsMulti42DataProvider::Generic_epsMulti42DataProvider:  Constructor executed");
+
+        connect_reader_thread_as_42_socket_client(
+            config.get("simulator.hardware-model.data-provider.hostname", "localhost"),
+            config.get("simulator.hardware-model.data-provider.port", 4242) );
+    }
+
+    void Generic_epsMulti42DataProvider::get_sun_vectors(const std::vector<std::int16_t>& spacecraft, std::vector<Generic_epsSunVector>& out) const
+    {
+        GENERIC_EPS_SIM_TRACE("Generic_epsMulti42DataProvider::get_sun_vectors:  Executed");
+
+        std::lock_guard<std::mutex> lock(_cache_mutex);
+
+        /*
+        ** A frame is identified by its 42 TIME line, not by the point object the socket provider hands out,
+        ** which may be rebuilt for the same frame or reused for a new one.  A frame without a time or no
+        ** frame at all is never cached.
+        */
+        const boost::shared_ptr<Sim42DataPoint> dp42 = boost::static_pointer_cast<Sim42DataPoint>(SimData42SocketProvider::get_data_point());
+        const std::vector<std::string> lines = dp42 ? dp42->get_lines() : std::vector<std::string>();
+        const std::string time = Generic_epsDataPoint::frame_time(lines);
+        if (!time.empty() && (time == _cache_time))
+        {
+            _cache_hits.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            _cache_misses.fetch_add(1, std::memory_order_relaxed);
+            _cache_time = time;
+            Generic_epsDataPoint::parse_sun_vectors(lines, _cache_sun);
+        }
+
+        std::size_t i;
+        out.resize(spacecraft.size());
+        for (i = 0; i < spacecraft.size(); i++)
+        {
+            if ((spacecraft[i] >= 0) && ((std::size_t)spacecraft[i] < _cache_sun.size()))
+            {
+                out[i] = _cache_sun[spacecraft[i]];
+            }
+            else
+            {
+                out[i].x = out[i].y = out[i].z = 0.0;
+                out[i].valid = false;
+            }
+        }
+    }
+}
@@ -0,0 +1,313 @@
+#include <cstdlib>
+
+#include <generic_eps_multi_hardware_model.hpp>
+
+namespace Nos3
+{
+    REGISTER_HARDWARE_MODEL(Generic_epsMultiHardwareModel,"GENERIC_EPS_MULTI");
+
+    extern ItcLogger::Logger *sim_logger;
+
+    Generic_epsMultiHardwareModel::Generic_epsMultiHardwareModel(const boost::property_tree::ptree& config) : SimIHardwareModel(config),
+    _fleet(_sim_microseconds_per_tick)
+    {
+        /* Optional, messages below this level are skipped before their arguments are formatted, otherwise sim_logger filters them */
+        std::string log_level = config.get("simulator.hardware-model.log-level", "");
+        if (!log_level.empty() && !Generic_epsSimLog::set_level(log_level))
+        {
+            sim_logger->error("Generic_epsMultiHardwareModel::Generic_epsMultiHardwareModel:  Unknown log level %s, leaving it to the logger configuration.", log_level.c_str());
+        }
+
+        /* Switch changes are sent from a worker so the I2C response never waits on the command bus */
+        _fanout.reset(new Generic_epsSwitchFanout([this](const std::string& node, bool on)
+            {
+                _command_node->send_non_confirmed_message_async(node, on ? 6 : 7, on ? "ENABLE" : "DISABLE");
+            }));
+
+        /* Get the NOS engine connection string */
+        std::string connection_string = config.get("common.nos-connection-string", "tcp://127.0.0.1:12001");
+        sim_logger->info("Generic_epsMultiHardwareModel::Generic_epsMultiHardwareModel:  NOS Engine connection string: %s.", connection_string.c_str());
+
+        /* One time bus and one command bus for every instance */
+        std::string time_bus_name = "command";
+        _command_bus_name = "command";
+        if (config.get_child_optional("simulator.hardware-model.connections"))
+        {
+            BOOST_FOREACH(const boost::property_tree::ptree::value_type &v, config.get_child("simulator.hardware-model.connections"))
+            {
+                if (v.second.get("type", "").compare("time") == 0)
+                {
+                    time_bus_name = v.second.get("bus-name", "command");
+                    _command_bus_name = time_bus_name;
+                    break;
+                }
+            }
+        }
+        _time_bus.reset(new NosEngine::Client::Bus(_hub, connection_string, time_bus_name));
+        _command_bus.reset(new NosEngine::Client::Bus(_hub, connection_string, _command_bus_name));
+        GENERIC_EPS_SIM_DEBUG("Generic_epsMultiHardwareModel::Generic_epsMultiHardwareModel:  Time bus %s now active.", time_bus_name.c_str());
+
+        /* One data provider for every instance */
+        std::string dp_name = config.get("simulator.hardware-model.data-provider.type", "GENERIC_EPS_MULTI_42_PROVIDER");
+        _generic_eps_dp = SimDataProviderFactory::Instance().Create(dp_name, config);
+        sim_logger->info("Generic_epsMultiHardwareModel::Generic_epsMultiHardwareModel:  Data provider %s created.", dp_name.c_str());
+        _fleet_source = dynamic_cast<Generic_epsSunVectorFleetSource*>(_generic_eps_dp);
+        _sun_source = dynamic_cast<Generic_epsSunVectorSource*>(_generic_eps_dp);
+
+        /*
+        ** Instances, each configured as a single EPS: the shared hardware-model settings with the instance's own blocks
+        ** (physical, i2c-timing and so on) in place of them.  Files are written per instance, so the shared i2c-log and
+        ** trace-file are not used.
+        */
+        boost::property_tree::ptree shared = config;
+        shared.get_child("simulator.hardware-model").erase("instances");
+        shared.get_child("simulator.hardware-model").erase("i2c-log");
+        shared.get_child("simulator.hardware-model").erase("trace-file");
+        if (config.get_child_optional("simulator.hardware-model.instances"))
+        {
+            /* Earlier instances answer I2C while later ones are added, their slots must not move */
+            _fleet.reserve(config.get_child("simulator.hardware-model.instances").count("instance"));
+
+            BOOST_FOREACH(const boost::property_tree::ptree::value_type &v, config.get_child("simulator.hardware-model.instances"))
+            {
+                if (v.first.compare("instance") != 0)
+                {
+                    continue;
+                }
+
+                boost::property_tree::ptree instance_config = shared;
+                BOOST_FOREACH(const boost::property_tree::ptree::value_type &w, v.second)
+                {
+                    if ((w.first.compare("spacecraft") != 0) && (w.first.compare("bus-name") != 0) && (w.first.compare("bus-address") != 0))
+                    {
+                        instance_config.get_child("simulator.hardware-model").put_child(w.first, w.second);
+                    }
+                }
+
+                /* No default bus or address, two instances left on the same one would both answer every transaction */
+                std::int16_t spacecraft = v.second.get("spacecraft", (int)_devices.size());
+                std::string bus_name = v.second.get("bus-name", "");
+                std::string address = v.second.get("bus-address", "");
+                char* address_end = nullptr;
+                long bus_address = std::strtol(address.c_str(), &address_end, 0);
+                if (bus_name.empty() || address.empty() || (*address_end != '\0') || (bus_address < 0) || (bus_address > 0x7F))
+                {
+                    sim_logger->error("Generic_epsMultiHardwareModel::Generic_epsMultiHardwareModel:  Spacecraft %d needs a bus-name and a 7 bit bus-address, "
+                        "not adding it.", spacecraft);
+                    continue;
+                }
+                std::pair<std::string, int> bus(bus_name, (int)bus_address);
+                if (std::find(_bus.begin(), _bus.end(), bus) != _bus.end())
+                {
+                    sim_logger->error("Generic_epsMultiHardwareModel::Generic_epsMultiHardwareModel:  Spacecraft %d is on %s address 0x%02lX like an "
+                        "earlier instance, not adding it.", spacecraft, bus_name.c_str(), bus_address);
+                    continue;
+                }
+                sim_logger->info("Generic_epsMultiHardwareModel::Generic_epsMultiHardwareModel:  Adding spacecraft %d on %s address 0x%02lX.",
+                    spacecraft, bus_name.c_str(), bus_address);
+                _devices.emplace_back(new Generic_epsI2CDevice(instance_config, _absolute_start_time, _sim_microseconds_per_tick,
+                    *_fanout, connection_string, bus_name, (int)bus_address, &_fleet));
+                _spacecraft.push_back(spacecraft);
+                _bus.push_back(bus);
+            }
+        }
+        _sun.resize(_devices.size());
+        _log_locks.reserve(_devices.size());
+        _time_bus->add_time_tick_callback(std::bind(&Generic_epsMultiHardwareModel::update_battery_values, this));
+
+        /* Construction complete */
+        sim_logger->info("Generic_epsMultiHardwareModel::Generic_epsMultiHardwareModel:  Construction complete with %lu instances.", (unsigned long)_devices.size());
+    }
+
+
+    Generic_epsMultiHardwareModel::~Generic_epsMultiHardwareModel(void)
+    {
+        /* Close the protocol buses and keep the power model traces if configured */
+        std::size_t n;
+        for (n = 0; n < _devices.size(); n++)
+        {
+            _devices[n]->close();
+        }
+
+        /* Send the switch changes still queued while the command node is up */
+        _fanout.reset();
+
+        /* Flush what is left of the I2C logs */
+        _devices.clear();
+
+        /* Clean up the data provider */
+        delete _generic_eps_dp;
+        _generic_eps_dp = nullptr;
+
+        /* The bus will clean up the time and sim nodes */
+    }
+
+
+    /* Automagically set up by the base class to be called */
+    void Generic_epsMultiHardwareModel::command_callback(NosEngine::Common::Message msg)
+    {
+        /* Get the data out of the message */
+        NosEngine::Common::DataBufferOverlay dbf(const_cast<NosEngine::Utility::Buffer&>(msg.buffer));
+        sim_logger->info("Generic_epsMultiHardwareModel::command_callback:  Received command: %s.", dbf.data);
+
+        /* Do something with the data */
+        std::string command = dbf.data;
+        std::string response = "Generic_epsMultiHardwareModel::command_callback:  INVALID COMMAND! (Try HELP)";
+        std::string prefix = "Generic_epsMultiHardwareModel::command_callback:  ";
+        boost::to_upper(command);
+
+        /* SC[n] <command> goes to the instance for spacecraft n, unprefixed EPS commands only work with a single instance */
+        Generic_epsI2CDevice* device = (_devices.size() == 1) ? _devices[0].get() : nullptr;
+        bool routed = false;
+        std::size_t end = command.find(']');
+        if ((command.compare(0, 3, "SC[") == 0) && (end != std::string::npos))
+        {
+            int spacecraft = std::atoi(command.substr(3, end - 3).c_str());
+            std::size_t n;
+            prefix += command.substr(0, end + 1) + " ";
+            device = nullptr;
+            for (n = 0; n < _devices.size(); n++)
+            {
+                if (_spacecraft[n] == spacecraft)
+                {
+                    device = _devices[n].get();
+                    break;
+                }
+            }
+            end = command.find_first_not_of(' ', end + 1);
+            command.erase(0, (end == std::string::npos) ? command.size() : end);
+            routed = true;
+        }
+
+        /* File names keep their case, upper casing left the lengths alone */
+        std::string sent = dbf.data;
+        sent.erase(0, sent.size() - command.size());
+        std::string argument = (sent.find('=') != std::string::npos) ? sent.substr(sent.find('=') + 1) : "";
+
+        if (routed)
+        {
+            if (device == nullptr)
+            {
+                response = prefix + "No such spacecraft";
+            }
+            else if (command.compare("READY") == 0)
+            {
+                response = prefix + (device->get_core().get_ready() ? "Ready" : "Not ready");
+            }
+            else if (command.compare("STATS") == 0)
+            {
+                response = prefix + device->get_stats();
+            }
+            else if (!device->command(command, argument, prefix, response))
+            {
+                response = prefix + "INVALID COMMAND! (Try HELP)";
+            }
+        }
+        else if (command.compare("HELP") == 0)
+        {
+            response = "Generic_epsMultiHardwareModel::command_callback: Valid commands are HELP, ENABLE, DISABLE, LOG=<TRACE|DEBUG|INFO|WARNING|ERROR|OFF>, READY, STATS, STOP, "
+                "or SC[<spacecraft>] followed by ENABLE, DISABLE, READY, STATS, TRACE=<file>, SAVE=<file>, LOAD=<file>, or statements separated by ';' "
+                "of SET <key>=<value> ... and GET <key or pattern> ... (GET * lists the keys); with one instance the SC[<spacecraft>] may be left off";
+        }
+        else if (command.compare(0, 4, "LOG=") == 0)
+        {
+            if (Generic_epsSimLog::set_level(command.substr(4)))
+            {
+                response = "Generic_epsMultiHardwareModel::command_callback:  Log level set to " + command.substr(4);
+            }
+            else
+            {
+                response = "Generic_epsMultiHardwareModel::command_callback:  Unknown log level " + command.substr(4);
+            }
+        }
+        else if ((command.compare("ENABLE") == 0) || (command.compare("DISABLE") == 0))
+        {
+            std::size_t n;
+            for (n = 0; n < _devices.size(); n++)
+            {
+                _devices[n]->get_core().set_enabled(command.compare("ENABLE") == 0);
+            }
+            response = (command.compare("ENABLE") == 0) ?
+                "Generic_epsMultiHardwareModel::command_callback:  Enabled" : "Generic_epsMultiHardwareModel::command_callback:  Disabled";
+        }
+        else if (command.compare("READY") == 0)
+        {
+            bool ready = true;
+            std::size_t n;
+            for (n = 0; n < _devices.size(); n++)
+            {
+                ready = ready && _devices[n]->get_core().get_ready();
+            }
+            response = ready ? "Generic_epsMultiHardwareModel::command_callback:  Ready" : "Generic_epsMultiHardwareModel::command_callback:  Not ready";
+        }
+        else if (command.compare("STATS") == 0)
+        {
+            response = "Generic_epsMultiHardwareModel::command_callback:  " + std::to_string(_devices.size()) + " instances";
+            Generic_epsMulti42DataProvider* dp42 = dynamic_cast<Generic_epsMulti42DataProvider*>(_generic_eps_dp);
+            if (dp42 != nullptr)
+            {
+                response += ", 42 data point cache hits " + std::to_string(dp42->get_cache_hits()) +
+                    ", misses " + std::to_string(dp42->get_cache_misses());
+            }
+            response += ", " + _fanout->get_stats();
+        }
+        else if (command.compare("STOP") == 0)
+        {
+            _keep_running = false;
+            response = "Generic_epsMultiHardwareModel::command_callback:  Stopping";
+        }
+        else if ((device != nullptr) && device->command(command, argument, prefix, response))
+        {
+            /* The only instance, as the single model would answer */
+        }
+        else if ((device == nullptr) && (Generic_epsBackdoor::is_request(command) || (command.compare(0, 6, "TRACE=") == 0) ||
+            (command.compare(0, 5, "SAVE=") == 0) || (command.compare(0, 5, "LOAD=") == 0)))
+        {
+            response = prefix + "Send SC[<spacecraft>] " + command.substr(0, command.find_first_of(" =")) +
+                " with " + std::to_string(_devices.size()) + " instances";
+        }
+
+        /* Send a reply */
+        sim_logger->info("Generic_epsMultiHardwareModel::command_callback:  Sending reply: %s.", response.c_str());
+        _command_node->send_reply_message_async(msg, response.size(), response.c_str());
+    }
+
+    void Generic_epsMultiHardwareModel::update_battery_values(void)
+    {
+        /* Every spacecraft's sun vector from one pass over the 42 frame */
+        if (_fleet_source != nullptr)
+        {
+            _fleet_source->get_sun_vectors(_spacecraft, _sun);
+        }
+        else
+        {
+            Generic_epsSunVector sun;
+            if (_sun_source != nullptr)
+            {
+                sun = _sun_source->get_sun_vector();
+            }
+            else
+            {
+                boost::shared_ptr<Generic_epsDataPoint> data_point = boost::dynamic_pointer_cast<Generic_epsDataPoint>(_generic_eps_dp->get_data_point());
+                sun.x = data_point->get_sun_vector_x();
+                sun.y = data_point->get_sun_vector_y();
+                sun.z = data_point->get_sun_vector_z();
+                sun.valid = data_point->is_generic_eps_data_valid();
+            }
+            std::fill(_sun.begin(), _sun.end(), sun);
+        }
+
+        /* A sun held through an instance's backdoor replaces the provider's, and is what its I2C log records */
+        std::uint64_t time = _time_bus->get_time();
+        std::size_t n;
+        for (n = 0; n < _devices.size(); n++)
+        {
+            _sun[n] = _devices[n]->get_core().get_sun(_sun[n]);
+            _log_locks.push_back(_devices[n]->record_sun(_sun[n], time));
+        }
+
+        /* One pass over every instance */
+        _fleet.tick(_sun.data(), time);
+        _log_locks.clear();
+    }
+}
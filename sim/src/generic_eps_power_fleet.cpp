@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cmath>
+
+#include <generic_eps_power_fleet.hpp>
+
+namespace Nos3
+{
+    std::size_t Generic_epsPowerFleet::add(const Generic_epsPowerModel& model)
+    {
+        std::uint8_t i;
+
+        _power_per_panel.push_back(model.get_power_per_panel());
+        _batt_min_voltage.push_back(0.95*model.get_nominal_battery_voltage());
+        _batt_diff.push_back(0.1*model.get_nominal_battery_voltage());
+        _max_battery.push_back(model.get_max_battery_watthrs());
+        _load_uw.push_back(model.get_load_uw());
+        _battery_pwh.push_back(model.get_battery_pwh());
+        _p_in.push_back(model.get_p_in());
+        _step_p_in.push_back(0.0);
+        _delta_pwh.push_back(0.0);
+
+        for (i = 0; i < GENERIC_EPS_POWER_NUM_BUSES; i++)
+        {
+            _bus.push_back(model.get_bus(i));
+        }
+        _switch.insert(_switch.end(), model.get_switches(), model.get_switches() + model.get_num_switches());
+        _switch_offset.push_back(_switch.size());
+        _switch_mask.push_back(model.get_switch_mask());
+
+        return _battery_pwh.size() - 1;
+    }
+
+    void Generic_epsPowerFleet::reserve(std::size_t instances, std::size_t switches)
+    {
+        _power_per_panel.reserve(instances);
+        _batt_min_voltage.reserve(instances);
+        _batt_diff.reserve(instances);
+        _max_battery.reserve(instances);
+        _load_uw.reserve(instances);
+        _battery_pwh.reserve(instances);
+        _p_in.reserve(instances);
+        _step_p_in.reserve(instances);
+        _delta_pwh.reserve(instances);
+        _bus.reserve(instances * GENERIC_EPS_POWER_NUM_BUSES);
+        _switch.reserve(switches);
+        _switch_offset.reserve(instances + 1);
+        _switch_mask.reserve(instances);
+    }
+
+    void Generic_epsPowerFleet::step(double seconds, const Generic_epsSunVector* sun, const std::uint64_t* ticks, std::uint8_t* changed)
+    {
+        const std::size_t count = _battery_pwh.size();
+        const double* power_per_panel = _power_per_panel.data();
+        const std::int64_t* load_uw = _load_uw.data();
+        double* step_p_in = _step_p_in.data();
+        double* delta_pwh = _delta_pwh.data();
+        std::size_t n;
+
+        /* Solar input and energy change per tick, no branches or calls so it vectorizes; same arithmetic as Generic_epsPowerModel::advance */
+        for (n = 0; n < count; n++)
+        {
+            double svb_X = (sun[n].x > 0) ? sun[n].x : 0.0;
+            double svb_minusX = (sun[n].x < 0) ? (-1)*sun[n].x : 0.0;
+            double svb_Y = (sun[n].y > 0) ? sun[n].y : 0.0;
+            double svb_Z = (sun[n].z > 0) ? sun[n].z : 0.0;
+            double p_out = load_uw[n] / 1000000.0;
+
+            step_p_in[n] = power_per_panel[n]*svb_X + power_per_panel[n]*svb_minusX + power_per_panel[n]*svb_Y + power_per_panel[n]*svb_Z;
+            delta_pwh[n] = (seconds * (step_p_in[n] - p_out))/3600 * GENERIC_EPS_POWER_PWH_PER_WH;
+        }
+
+        /* Integer accumulate and the battery voltage, for the instances that stepped */
+        for (n = 0; n < count; n++)
+        {
+            changed[n] = 0;
+            if (ticks[n] == 0)
+            {
+                continue;
+            }
+            _p_in[n] = step_p_in[n];
+            _battery_pwh[n] += std::llround(delta_pwh[n]) * (std::int64_t)ticks[n];
+            changed[n] = set_battery_voltage(n);
+        }
+    }
+
+    bool Generic_epsPowerFleet::advance(std::size_t n, double seconds, const Generic_epsSunVector& sun, std::uint64_t ticks)
+    {
+        double svb_X = (sun.x > 0) ? sun.x : 0.0;
+        double svb_minusX = (sun.x < 0) ? (-1)*sun.x : 0.0;
+        double svb_Y = (sun.y > 0) ? sun.y : 0.0;
+        double svb_Z = (sun.z > 0) ? sun.z : 0.0;
+        double p_out = _load_uw[n] / 1000000.0;
+
+        _p_in[n] = _power_per_panel[n]*svb_X + _power_per_panel[n]*svb_minusX + _power_per_panel[n]*svb_Y + _power_per_panel[n]*svb_Z;
+        _battery_pwh[n] += std::llround((seconds * (_p_in[n] - p_out))/3600 * GENERIC_EPS_POWER_PWH_PER_WH) * (std::int64_t)ticks;
+        return set_battery_voltage(n);
+    }
+
+    bool Generic_epsPowerFleet::set_battery_voltage(std::size_t n)
+    {
+        Generic_epsPowerModel::EPS_Rail& battery = _bus[n * GENERIC_EPS_POWER_NUM_BUSES];
+        battery._battery_watthrs = _battery_pwh[n] / GENERIC_EPS_POWER_PWH_PER_WH;
+
+        std::uint16_t batt_voltage = 1000*(_batt_min_voltage[n] + _batt_diff[n]*(battery._battery_watthrs / _max_battery[n]));
+        if (batt_voltage != battery._voltage)
+        {
+            battery._voltage = batt_voltage;
+            return true;
+        }
+        return false;
+    }
+
+    bool Generic_epsPowerFleet::restore(std::size_t n, const Generic_epsPowerModel& model)
+    {
+        if (model.get_num_switches() != get_num_switches(n))
+        {
+            return false;
+        }
+
+        /* Only the state a step or switch change moves, the parameters came from the same model */
+        _load_uw[n] = model.get_load_uw();
+        _battery_pwh[n] = model.get_battery_pwh();
+        _p_in[n] = model.get_p_in();
+        std::copy(&model.get_bus(0), &model.get_bus(0) + GENERIC_EPS_POWER_NUM_BUSES, _bus.begin() + n * GENERIC_EPS_POWER_NUM_BUSES);
+        std::copy(model.get_switches(), model.get_switches() + model.get_num_switches(), _switch.begin() + _switch_offset[n]);
+        _switch_mask[n] = model.get_switch_mask();
+        return true;
+    }
+
+    bool Generic_epsPowerFleet::store(std::size_t n, Generic_epsPowerModel& model) const
+    {
+        return model.restore(get_bus(n), get_switch(n), get_num_switches(n), _battery_pwh[n], _p_in[n]);
+    }
+
+    bool Generic_epsPowerFleet::set_switch_status(std::size_t n, std::uint8_t sw_num, std::uint16_t sw_status)
+    {
+        if (sw_num >= get_num_switches(n))
+        {
+            return false;
+        }
+
+        Generic_epsPowerModel::EPS_Rail& sw = _switch[_switch_offset[n] + sw_num];
+        if (sw._status == sw_status)
+        {
+            return false;
+        }
+
+        _load_uw[n] -= switch_load_uw(n, sw_num);
+        sw._status = sw_status;
+        _load_uw[n] += switch_load_uw(n, sw_num);
+
+        if ((sw_status & 0x00FF) == 0x00AA)
+        {
+            _switch_mask[n] |= (std::uint64_t)1 << sw_num;
+        }
+        else
+        {
+            _switch_mask[n] &= ~((std::uint64_t)1 << sw_num);
+        }
+        return true;
+    }
+
+    void Generic_epsPowerFleet::set_battery_watthrs(std::size_t n, double watthrs)
+    {
+        _battery_pwh[n] = std::llround(watthrs * GENERIC_EPS_POWER_PWH_PER_WH);
+        _bus[n * GENERIC_EPS_POWER_NUM_BUSES]._battery_watthrs = _battery_pwh[n] / GENERIC_EPS_POWER_PWH_PER_WH;
+    }
+
+    void Generic_epsPowerFleet::fill_trace_record(std::size_t n, double sim_time, Generic_epsTraceRecord& rec) const
+    {
+        rec.sim_time = sim_time;
+        rec.battery_watthrs = get_battery_watthrs(n);
+        rec.p_in = _p_in[n];
+        rec.p_out = get_p_out(n);
+        rec.switch_mask = _switch_mask[n];
+        rec.battery_mv = get_bus(n)[0]._voltage;
+        rec.spare[0] = rec.spare[1] = rec.spare[2] = 0;
+    }
+
+    std::int64_t Generic_epsPowerFleet::switch_load_uw(std::size_t n, std::uint8_t sw_num) const
+    {
+        const Generic_epsPowerModel::EPS_Rail& sw = _switch[_switch_offset[n] + sw_num];
+        return (sw._status != 0) ? (std::int64_t)sw._voltage * sw._current : 0;
+    }
+}
@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <generic_eps_power_model.hpp>
+
+namespace Nos3
+{
+    Generic_epsPowerModel::Generic_epsPowerModel(const boost::property_tree::ptree& config) : _p_in(0.0)
+    {
+        std::memset(_bus, 0, sizeof(_bus));
+
+        /* Initialize status for battery, solar array */
+        std::string battv, battv_temp, batt_watt_hrs, solararray, solararray_temp, solararray_current;
+
+        // Below, the battery watt-hrs variable arbitrarily selected - it could well 
+        // do to be changed to be more in line with true spacecraft values.
+        // Additionally, the current values (as indicated) are placeholders and should
+        // probably be changed to something more correct.
+
+        _power_per_panel = atof(config.get("simulator.hardware-model.physical.bus.solar-array-power-per-panel", "26.91").c_str()); //Power generated, in Watts; data taken from GTOSat
+
+        battv = config.get("simulator.hardware-model.physical.bus.battery-voltage", "24.0");
+        battv_temp = config.get("simulator.hardware-model.physical.bus.battery-temperature", "25.0");
+        batt_watt_hrs = config.get("simulator.hardware-model.physical.bus.battery-watt-hrs", "10.0");
+        solararray = config.get("simulator.hardware-model.physical.bus.solar-array-voltage", "32.0");
+        solararray_temp = config.get("simulator.hardware-model.physical.bus.solar-array-temperature", "80.0");
+        solararray_current = config.get("simulator.hardware-model.physical.bus.solar-array-current", "4.0");
+
+
+        /* Initialize status for buses */
+        std::string bus_low_volt, bus_mid_volt, bus_high_volt, bus_low_current, bus_mid_current, bus_high_current;
+
+        bus_low_volt = config.get("simulator.hardware-model.physical.bus.bus-low-voltage", "3.3");
+        bus_mid_volt = config.get("simulator.hardware-model.physical.bus.bus-mid-voltage", "5.0");
+        bus_high_volt = config.get("simulator.hardware-model.physical.bus.bus-high-voltage", "12.0");
+
+        bus_low_current = config.get("simulator.hardware-model.physical.bus.bus-low-current", "1.0");
+        bus_mid_current = config.get("simulator.hardware-model.physical.bus.bus-mid-current", "1.0");
+        bus_high_current = config.get("simulator.hardware-model.physical.bus.bus-high-current", "1.0");
+
+        _nominal_batt_voltage = atoi(battv.c_str());
+        _max_battery = atof(batt_watt_hrs.c_str());
+
+        _bus[0]._voltage = atoi(battv.c_str()) * 1000;
+        _bus[0]._temperature = (atoi(battv_temp.c_str()) + 60) * 100;
+        set_battery_watthrs(atof(batt_watt_hrs.c_str()));
+        _bus[1]._voltage = atof(bus_low_volt.c_str()) * 1000;
+        _bus[2]._voltage = atof(bus_mid_volt.c_str()) * 1000;
+        _bus[3]._voltage = atof(bus_high_volt.c_str()) * 1000;
+        _bus[4]._voltage = atoi(solararray.c_str()) * 1000;
+        _bus[4]._temperature = (atoi(solararray_temp.c_str()) + 60) * 100;
+        _bus[4]._current = atof(solararray_current.c_str()) * 1000;
+        _bus[1]._current = atof(bus_low_current.c_str()) * 1000;
+        _bus[2]._current = atof(bus_mid_current.c_str()) * 1000;
+        _bus[3]._current = atof(bus_high_current.c_str()) * 1000;
+
+        /* Initialize status for each switch, switches past the first eight default to 3.3V at 0.25A */
+        static const char* const default_voltage[GENERIC_EPS_POWER_NUM_SWITCHES] = {"3.30", "3.30", "5.00", "5.00", "12.00", "12.00", "3.30", "5.00"};
+        static const char* const default_current[GENERIC_EPS_POWER_NUM_SWITCHES] = {"0.25", "0.10", "0.20", "0.30", "0.40", "0.50", "0.60", "0.70"};
+        int num_switches = config.get("simulator.hardware-model.physical.switch-count", GENERIC_EPS_POWER_NUM_SWITCHES);
+        num_switches = (num_switches < 0) ? 0 : ((num_switches > GENERIC_EPS_POWER_MAX_SWITCHES) ? GENERIC_EPS_POWER_MAX_SWITCHES : num_switches);
+        _switch.assign(num_switches, EPS_Rail());
+
+        std::uint8_t i;
+        for (i = 0; i < _switch.size(); i++)
+        {
+            std::string key = "simulator.hardware-model.physical.switch-" + std::to_string(i);
+            _switch[i]._voltage = atof(config.get(key + ".voltage", (i < GENERIC_EPS_POWER_NUM_SWITCHES) ? default_voltage[i] : "3.30").c_str()) * 1000;
+            _switch[i]._current = atof(config.get(key + ".current", (i < GENERIC_EPS_POWER_NUM_SWITCHES) ? default_current[i] : "0.25").c_str()) * 1000;
+            _switch[i]._status = std::stoi(config.get(key + ".hex-status", "0000"), 0, 16);
+        }
+
+        recompute_load();
+    }
+
+    void Generic_epsPowerModel::recompute_load(void)
+    {
+        std::uint8_t i;
+
+        /* Updated by delta from here on */
+        _load_uw = 0;
+        _switch_mask = 0;
+        for (i = 1; i < 4; i++)
+        {
+            _load_uw += bus_load_uw(i);
+        }
+        for (i = 0; i < _switch.size(); i++)
+        {
+            _load_uw += switch_load_uw(i);
+            if ((_switch[i]._status & 0x00FF) == 0x00AA)
+            {
+                _switch_mask |= (std::uint64_t)1 << i;
+            }
+        }
+    }
+
+    void Generic_epsPowerModel::set_battery_watthrs(double watthrs)
+    {
+        _battery_pwh = std::llround(watthrs * GENERIC_EPS_POWER_PWH_PER_WH);
+        _bus[0]._battery_watthrs = _battery_pwh / GENERIC_EPS_POWER_PWH_PER_WH;
+    }
+
+    bool Generic_epsPowerModel::restore(const EPS_Rail* bus, const EPS_Rail* sw, std::uint8_t num_switches, std::int64_t battery_pwh, double p_in)
+    {
+        if (num_switches != _switch.size())
+        {
+            return false;
+        }
+
+        std::memcpy(_bus, bus, sizeof(_bus));
+        std::copy(sw, sw + num_switches, _switch.begin());
+        _battery_pwh = battery_pwh;
+        _bus[0]._battery_watthrs = _battery_pwh / GENERIC_EPS_POWER_PWH_PER_WH;
+        _p_in = p_in;
+        recompute_load();
+        return true;
+    }
+
+    bool Generic_epsPowerModel::advance(double seconds, const Generic_epsSunVector& sun, std::uint64_t ticks)
+    {
+        double svb_X = (sun.x > 0) ? sun.x : 0.0;
+        double svb_minusX = (sun.x < 0) ? (-1)*sun.x : 0.0;
+        double svb_Y = (sun.y > 0) ? sun.y : 0.0;
+        double svb_Z = (sun.z > 0) ? sun.z : 0.0;
+
+        /* Note: Assuming solar arrays on all +/- X, Y, and Z faces */
+        // The "cosine effect" is the most relevant part, affecting the power
+        // received. I have no idea if it impacts the voltage or the current,
+        // but theoretically it should not matter - I can just multiply times
+        // the whole thing.
+        // Technically, when the angle to the sun is greater than 45 degrees
+        // there begins to be significant light reflected away, an effect which
+        // is not replicated here.
+
+        /* Load total is kept by delta on every switch or rail change */
+        double p_out = _load_uw / 1000000.0;
+
+        _p_in = _power_per_panel*svb_X + _power_per_panel*svb_minusX + _power_per_panel*svb_Y + _power_per_panel*svb_Z;
+        double delta_p = (seconds * (_p_in - p_out));
+        std::int64_t delta_pwh = std::llround(delta_p/3600 * GENERIC_EPS_POWER_PWH_PER_WH); //The 3600 is for converting Watt-seconds (the units of delta_p) into watt-hours
+
+        /* Same per tick delta whether the ticks arrive together or one at a time */
+        _battery_pwh += delta_pwh * (std::int64_t)ticks;
+        _bus[0]._battery_watthrs = _battery_pwh / GENERIC_EPS_POWER_PWH_PER_WH;
+
+        // Here is the code to increase or decrease the value of the battery
+        // voltage. It is linear and +- 5% of the nominal voltage, which is
+        // a value I came across when doing some research.
+
+        double batt_min_voltage = 0.95*_nominal_batt_voltage;
+        double batt_diff = 0.1*_nominal_batt_voltage;
+
+        std::uint16_t batt_voltage = 1000*(batt_min_voltage + batt_diff*(_bus[0]._battery_watthrs / _max_battery));
+        if (batt_voltage != _bus[0]._voltage)
+        {
+            _bus[0]._voltage = batt_voltage;
+            return true;
+        }
+        return false;
+    }
+
+    bool Generic_epsPowerModel::set_switch_status(std::uint8_t sw_num, std::uint16_t sw_status)
+    {
+        if ((sw_num >= _switch.size()) || (_switch[sw_num]._status == sw_status))
+        {
+            return false;
+        }
+
+        _load_uw -= switch_load_uw(sw_num);
+        _switch[sw_num]._status = sw_status;
+        _load_uw += switch_load_uw(sw_num);
+
+        if ((sw_status & 0x00FF) == 0x00AA)
+        {
+            _switch_mask |= (std::uint64_t)1 << sw_num;
+        }
+        else
+        {
+            _switch_mask &= ~((std::uint64_t)1 << sw_num);
+        }
+        return true;
+    }
+
+    void Generic_epsPowerModel::set_bus(std::uint8_t bus_num, const EPS_Rail& rail)
+    {
+        if (bus_num >= GENERIC_EPS_POWER_NUM_BUSES)
+        {
+            return;
+        }
+
+        /* Only the regulated rails count towards the load */
+        bool regulated = (bus_num >= 1) && (bus_num <= 3);
+        if (regulated)
+        {
+            _load_uw -= bus_load_uw(bus_num);
+        }
+        _bus[bus_num]._voltage = rail._voltage;
+        _bus[bus_num]._current = rail._current;
+        _bus[bus_num]._status = rail._status;
+        _bus[bus_num]._temperature = rail._temperature;
+        if (regulated)
+        {
+            _load_uw += bus_load_uw(bus_num);
+        }
+    }
+
+    void Generic_epsPowerModel::set_switch(std::uint8_t sw_num, const EPS_Rail& rail)
+    {
+        if (sw_num >= _switch.size())
+        {
+            return;
+        }
+
+        _load_uw -= switch_load_uw(sw_num);
+        _switch[sw_num]._voltage = rail._voltage;
+        _switch[sw_num]._current = rail._current;
+        _switch[sw_num]._temperature = rail._temperature;
+        _load_uw += switch_load_uw(sw_num);
+        set_switch_status(sw_num, rail._status);
+    }
+
+    void Generic_epsPowerModel::fill_trace_record(double sim_time, Generic_epsTraceRecord& rec) const
+    {
+        rec.sim_time = sim_time;
+        rec.battery_watthrs = _bus[0]._battery_watthrs;
+        rec.p_in = _p_in;
+        rec.p_out = get_p_out();
+        rec.switch_mask = _switch_mask;
+        rec.battery_mv = _bus[0]._voltage;
+        rec.spare[0] = rec.spare[1] = rec.spare[2] = 0;
+    }
+
+    std::int64_t Generic_epsPowerModel::bus_load_uw(std::uint8_t bus_num) const
+    {
+        return (std::int64_t)_bus[bus_num]._voltage * _bus[bus_num]._current;
+    }
+
+    std::int64_t Generic_epsPowerModel::switch_load_uw(std::uint8_t sw_num) const
+    {
+        return (_switch[sw_num]._status != 0) ? (std::int64_t)_switch[sw_num]._voltage * _switch[sw_num]._current : 0;
+    }
+}
@@ -0,0 +1,25 @@
+#include <boost/algorithm/string.hpp>
+#include <generic_eps_sim_log.hpp>
+
+namespace Nos3
+{
+    /* Nothing is filtered here until a level is configured, sim_logger's own configuration decides */
+    std::atomic<int> Generic_epsSimLog::_level(GENERIC_EPS_SIM_LOG_TRACE);
+
+    bool Generic_epsSimLog::set_level(const std::string& name)
+    {
+        static const char* const names[] = {"TRACE", "DEBUG", "INFO", "WARNING", "ERROR", "OFF"};
+        std::string upper = boost::to_upper_copy(name);
+        int level;
+
+        for (level = GENERIC_EPS_SIM_LOG_TRACE; level <= GENERIC_EPS_SIM_LOG_OFF; level++)
+        {
+            if (upper.compare(names[level]) == 0)
+            {
+                set_level(level);
+                return true;
+            }
+        }
+        return false;
+    }
+}
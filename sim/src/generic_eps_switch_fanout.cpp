@@ -0,0 +1,119 @@
+#include <chrono>
+#include <cstdio>
+
+#include <generic_eps_switch_fanout.hpp>
+
+namespace Nos3
+{
+    static std::int64_t fanout_now_ns(void)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    Generic_epsSwitchFanout::Generic_epsSwitchFanout(Send send) :
+    _send(send), _stop(false), _posted(0), _sent(0), _total_latency_ns(0), _max_latency_ns(0)
+    {
+        /* Started last, every member it uses is ready */
+        _thread = std::thread(&Generic_epsSwitchFanout::worker, this);
+    }
+
+    Generic_epsSwitchFanout::~Generic_epsSwitchFanout(void)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_one();
+        _thread.join();
+    }
+
+    void Generic_epsSwitchFanout::post(const std::string& node, bool on)
+    {
+        std::int64_t now = fanout_now_ns();
+        bool wake;
+
+        _posted.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            std::unordered_map<std::string, Pending>::iterator it = _pending.find(node);
+            if (it != _pending.end())
+            {
+                /* Still queued, only the final state goes out and the latency counts from the first change */
+                it->second.on = on;
+                return;
+            }
+            Pending pending = {on, now};
+            _pending[node] = pending;
+            _order.push_back(node);
+            wake = (_order.size() == 1);
+        }
+        if (wake)
+        {
+            _wake.notify_one();
+        }
+    }
+
+    void Generic_epsSwitchFanout::worker(void)
+    {
+        std::vector<std::string> order;
+        std::vector<Pending> batch;
+        std::size_t i;
+
+        for (;;)
+        {
+            /* Take everything queued so far, posts carry on while it is sent */
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                while (_order.empty() && !_stop)
+                {
+                    _wake.wait(lock);
+                }
+                if (_order.empty())
+                {
+                    return;
+                }
+                order.swap(_order);
+                batch.clear();
+                for (i = 0; i < order.size(); i++)
+                {
+                    batch.push_back(_pending[order[i]]);
+                }
+                _pending.clear();
+            }
+
+            for (i = 0; i < order.size(); i++)
+            {
+                std::unordered_map<std::string, bool>::iterator last = _delivered.find(order[i]);
+                if ((last != _delivered.end()) && (last->second == batch[i].on))
+                {
+                    continue; /* Toggled back to what the node already has */
+                }
+                _send(order[i], batch[i].on);
+                _delivered[order[i]] = batch[i].on;
+
+                std::uint64_t latency = (std::uint64_t)(fanout_now_ns() - batch[i].queued_ns);
+                _sent.fetch_add(1, std::memory_order_relaxed);
+                _total_latency_ns.fetch_add(latency, std::memory_order_relaxed);
+                if (latency > _max_latency_ns.load(std::memory_order_relaxed))
+                {
+                    _max_latency_ns.store(latency, std::memory_order_relaxed);
+                }
+            }
+            order.clear();
+        }
+    }
+
+    std::uint64_t Generic_epsSwitchFanout::get_mean_latency_ns(void) const
+    {
+        std::uint64_t sent = get_sent();
+        return (sent > 0) ? _total_latency_ns.load(std::memory_order_relaxed) / sent : 0;
+    }
+
+    std::string Generic_epsSwitchFanout::get_stats(void) const
+    {
+        char buf[160];
+        std::snprintf(buf, sizeof(buf), "switch changes %llu, messages sent %llu, delivery latency mean %.1f us max %.1f us",
+            (unsigned long long)get_posted(), (unsigned long long)get_sent(), get_mean_latency_ns() / 1000.0, get_max_latency_ns() / 1000.0);
+        return buf;
+    }
+}
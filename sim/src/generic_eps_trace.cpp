@@ -0,0 +1,115 @@
+#include <cstdio>
+#include <cstring>
+
+#include <generic_eps_trace.hpp>
+
+namespace Nos3
+{
+    Generic_epsTrace::Generic_epsTrace(std::uint32_t depth) : _head(0)
+    {
+        /* Round up to a power of two so the index is a mask */
+        std::uint64_t size = 1;
+        while (size < depth)
+        {
+            size <<= 1;
+        }
+        _records.resize(size);
+        _mask = size - 1;
+    }
+
+    void Generic_epsTrace::snapshot(std::vector<Generic_epsTraceRecord>& out) const
+    {
+        std::uint64_t size = _mask + 1;
+        std::uint64_t head = _head.load(std::memory_order_acquire);
+        std::uint64_t first = (head > size) ? head - size : 0;
+        std::uint64_t i;
+
+        out.clear();
+        out.reserve(head - first);
+        for (i = first; i < head; i++)
+        {
+            out.push_back(_records[i & _mask]);
+        }
+
+        /* Drop anything the producer may have overwritten while copying */
+        std::uint64_t now = _head.load(std::memory_order_acquire);
+        if (now > first + size)
+        {
+            std::uint64_t stale = now - (first + size);
+            if (stale > out.size())
+            {
+                stale = out.size();
+            }
+            out.erase(out.begin(), out.begin() + stale);
+        }
+    }
+
+    std::int64_t Generic_epsTrace::dump(const std::string& filename) const
+    {
+        std::vector<Generic_epsTraceRecord> recs;
+
+        snapshot(recs);
+        return write(filename, recs);
+    }
+
+    std::int64_t Generic_epsTrace::write(const std::string& filename, const std::vector<Generic_epsTraceRecord>& recs)
+    {
+        Generic_epsTraceHeader hdr;
+        std::FILE* fp;
+        bool ok;
+
+        std::memset(&hdr, 0, sizeof(hdr));
+        std::memcpy(hdr.magic, GENERIC_EPS_TRACE_MAGIC, sizeof(hdr.magic));
+        hdr.version = GENERIC_EPS_TRACE_VERSION;
+        hdr.record_size = sizeof(Generic_epsTraceRecord);
+        hdr.count = recs.size();
+
+        fp = std::fopen(filename.c_str(), "wb");
+        if (fp == NULL)
+        {
+            return -1;
+        }
+        ok = (std::fwrite(&hdr, sizeof(hdr), 1, fp) == 1);
+        if (ok && !recs.empty())
+        {
+            ok = (std::fwrite(recs.data(), sizeof(Generic_epsTraceRecord), recs.size(), fp) == recs.size());
+        }
+        ok = (std::fclose(fp) == 0) && ok;
+
+        return ok ? (std::int64_t)recs.size() : -1;
+    }
+
+    bool Generic_epsTrace::load(const std::string& filename, std::vector<Generic_epsTraceRecord>& out)
+    {
+        Generic_epsTraceHeader hdr;
+        std::FILE* fp;
+        bool ok;
+
+        out.clear();
+        fp = std::fopen(filename.c_str(), "rb");
+        if (fp == NULL)
+        {
+            return false;
+        }
+        ok = (std::fread(&hdr, sizeof(hdr), 1, fp) == 1) &&
+             (std::memcmp(hdr.magic, GENERIC_EPS_TRACE_MAGIC, sizeof(hdr.magic)) == 0) &&
+             (hdr.version == GENERIC_EPS_TRACE_VERSION) &&
+             (hdr.record_size == sizeof(Generic_epsTraceRecord));
+        if (ok)
+        {
+            /* The count must fit in what the file holds after the header, a corrupt one must not size the allocation */
+            long start = std::ftell(fp);
+            ok = (start >= 0) && (std::fseek(fp, 0, SEEK_END) == 0);
+            long end = ok ? std::ftell(fp) : -1;
+            ok = ok && (end >= start) && (std::fseek(fp, start, SEEK_SET) == 0) &&
+                 (hdr.count <= (std::uint64_t)(end - start) / sizeof(Generic_epsTraceRecord));
+        }
+        if (ok)
+        {
+            out.resize(hdr.count);
+            ok = (hdr.count == 0) || (std::fread(out.data(), sizeof(Generic_epsTraceRecord), out.size(), fp) == out.size());
+        }
+        std::fclose(fp);
+        return ok;
+    }
+}
@@ -0,0 +1,119 @@
+/*
+** Run the EPS power model faster than real time with no NOS Engine
+**
+** Usage: generic_eps_batch [-s schedule] [-d seconds] [-m tick|event] [-k microseconds] [-e ticks] [-l checkpoint] [-o trace file] <simulator config>
+**
+** The config is either a simulator block as in cfg/nos3-eps-simulator.xml or a full
+** nos3-simulator.xml, in which case the GENERIC_EPS simulator is used.
+**
+** Schedule lines are "<seconds> SWITCH <n> <hex status>" or "<seconds> SUN <x> <y> <z>",
+** '#' starts a comment.  The sun vector is zero until the first SUN line.
+**
+** Every e-th tick is written in the trace format, decode it with generic_eps_trace_decode.
+** A checkpoint saved with the SAVE=<file> backdoor command replaces the configured starting state.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include <generic_eps_batch.hpp>
+#include <generic_eps_checkpoint.hpp>
+
+static void usage(const char* name)
+{
+    std::fprintf(stderr, "Usage: %s [-s schedule] [-d seconds] [-m tick|event] [-k microseconds per tick] [-e ticks per record] [-l checkpoint] [-o trace file] <simulator config>\n", name);
+}
+
+int main(int argc, char* argv[])
+{
+    std::string schedule_file;
+    std::string checkpoint_file;
+    std::string trace_file = "generic_eps_batch.trace";
+    double duration = 86400.0;
+    bool event_integration = true;
+    std::int64_t tick_us = 0;
+    std::uint64_t every = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:d:k:e:l:o:m:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 's': schedule_file = optarg; break;
+            case 'd': duration = std::atof(optarg); break;
+            case 'm': event_integration = (std::string(optarg).compare("tick") != 0); break;
+            case 'k': tick_us = std::atoll(optarg); break;
+            case 'e': every = std::strtoull(optarg, NULL, 10); break;
+            case 'l': checkpoint_file = optarg; break;
+            case 'o': trace_file = optarg; break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (optind != argc - 1)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    boost::property_tree::ptree config;
+    if (!Nos3::Generic_epsBatch::load_config(argv[optind], config))
+    {
+        return 1;
+    }
+
+    /* Same tick length as the simulator unless overridden */
+    if (tick_us <= 0)
+    {
+        tick_us = config.get("common.sim-microseconds-per-tick", 10000);
+    }
+    if (tick_us <= 0)
+    {
+        std::fprintf(stderr, "%s: tick length must be positive\n", argv[0]);
+        return 1;
+    }
+    if (every == 0)
+    {
+        every = std::max<std::uint64_t>(1, 1000000 / tick_us); /* Once a simulated second */
+    }
+
+    Nos3::Generic_epsBatch batch(tick_us, duration, event_integration);
+    if (!schedule_file.empty() && !batch.load_schedule(schedule_file))
+    {
+        return 1;
+    }
+
+    Nos3::Generic_epsPowerModel power(config);
+    if (!checkpoint_file.empty())
+    {
+        Nos3::Generic_epsCheckpoint checkpoint;
+        std::uint8_t enabled, initialized_other_sims;
+        if (!checkpoint.read(checkpoint_file) || !checkpoint.apply(power, enabled, initialized_other_sims))
+        {
+            std::fprintf(stderr, "%s: %s is not a checkpoint with %d switches\n", argv[0], checkpoint_file.c_str(), power.get_num_switches());
+            return 1;
+        }
+    }
+    std::vector<Nos3::Generic_epsTraceRecord> recs;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    Nos3::Generic_epsBatchResult result = batch.run(power, 0.0, every, &recs);
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (Nos3::Generic_epsTrace::write(trace_file, recs) < 0)
+    {
+        std::fprintf(stderr, "%s: unable to write %s\n", argv[0], trace_file.c_str());
+        return 1;
+    }
+
+    std::printf("ticks %llu of %lld us in %.3f s (%.0f ticks/s)\n",
+        (unsigned long long)batch.get_ticks(), (long long)tick_us, wall, (wall > 0.0) ? batch.get_ticks() / wall : 0.0);
+    std::printf("battery final %.6f Wh, minimum %.6f Wh at %.3f s\n", result.final_watthrs, result.min_watthrs, result.min_time);
+    std::printf("wrote %llu records to %s\n", (unsigned long long)recs.size(), trace_file.c_str());
+    return 0;
+}
@@ -0,0 +1,216 @@
+/*
+** Replay an I2C log recorded by the simulator against the EPS model with no NOS Engine, diffing every response
+**
+** Usage: generic_eps_i2c_replay [-l checkpoint] [-n mismatches shown] <i2c log> <simulator config>
+**
+** Record with <i2c-log>file</i2c-log> in the hardware model config.  The config given here should be the one
+** recorded with, or a changed one to check a model change against recorded traffic.
+** Ticks are applied one by one with the recorded sun between records, so the model sees what it saw live.
+** Exits 1 on any mismatch.
+*/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <generic_eps_batch.hpp>
+#include <generic_eps_core.hpp>
+#include <generic_eps_i2c_log.hpp>
+
+namespace Nos3
+{
+    /* Debug logging is gated off in main, nothing is written through it */
+    ItcLogger::Logger *sim_logger = NULL;
+}
+
+static void usage(const char* name)
+{
+    std::fprintf(stderr, "Usage: %s [-l checkpoint] [-n mismatches shown] <i2c log> <simulator config>\n", name);
+}
+
+static void print_mismatch(std::uint64_t index, double sim_time, const Nos3::Generic_epsI2CLogRecord& rec, const std::uint8_t* payload,
+    std::uint8_t valid, const Nos3::Generic_epsI2CResponse& out_data, std::size_t out_len)
+{
+    char hex_str[GENERIC_EPS_SIM_HEX_STR_LEN];
+
+    std::printf("transaction %llu at %.6f s: request %s\n", (unsigned long long)index, sim_time,
+        Nos3::Generic_epsCore::uint8_array_to_hex_string(payload, rec.write_len, hex_str, sizeof(hex_str)));
+    std::printf("  recorded valid %u [%u] %s\n", rec.valid, rec.read_len,
+        Nos3::Generic_epsCore::uint8_array_to_hex_string(payload + rec.write_len, rec.read_len, hex_str, sizeof(hex_str)));
+    std::printf("  replayed valid %u [%u] %s\n", valid, (unsigned)out_len,
+        Nos3::Generic_epsCore::uint8_array_to_hex_string(out_data.data(), out_len, hex_str, sizeof(hex_str)));
+}
+
+int main(int argc, char* argv[])
+{
+    std::string checkpoint_file;
+    std::uint64_t max_shown = 10;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "l:n:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'l': checkpoint_file = optarg; break;
+            case 'n': max_shown = std::strtoull(optarg, NULL, 10); break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if (optind != argc - 2)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    const char* log_file = argv[optind];
+
+    /* There is no logger behind sim_logger, gate everything before it */
+    Nos3::Generic_epsSimLog::set_level(GENERIC_EPS_SIM_LOG_OFF);
+
+    boost::property_tree::ptree config;
+    if (!Nos3::Generic_epsBatch::load_config(argv[optind + 1], config))
+    {
+        return 1;
+    }
+
+    /* Map the whole log, records are walked in place */
+    int fd = open(log_file, O_RDONLY);
+    struct stat st;
+    if ((fd < 0) || (fstat(fd, &st) != 0))
+    {
+        std::fprintf(stderr, "%s: unable to open %s\n", argv[0], log_file);
+        return 1;
+    }
+    std::size_t size = (std::size_t)st.st_size;
+    if (size < sizeof(Nos3::Generic_epsI2CLogHeader))
+    {
+        std::fprintf(stderr, "%s: %s is not a valid version %d EPS I2C log\n", argv[0], log_file, GENERIC_EPS_I2C_LOG_VERSION);
+        return 1;
+    }
+    const std::uint8_t* base = (const std::uint8_t*)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == (const std::uint8_t*)MAP_FAILED)
+    {
+        std::fprintf(stderr, "%s: unable to map %s\n", argv[0], log_file);
+        return 1;
+    }
+    madvise((void*)base, size, MADV_SEQUENTIAL);
+
+    Nos3::Generic_epsI2CLogHeader hdr;
+    std::memcpy(&hdr, base, sizeof(hdr));
+    if ((std::memcmp(hdr.magic, GENERIC_EPS_I2C_LOG_MAGIC, sizeof(hdr.magic)) != 0) ||
+        (hdr.version != GENERIC_EPS_I2C_LOG_VERSION) ||
+        (hdr.record_size != sizeof(Nos3::Generic_epsI2CLogRecord)) ||
+        (hdr.microseconds_per_tick <= 0))
+    {
+        std::fprintf(stderr, "%s: %s is not a valid version %d EPS I2C log\n", argv[0], log_file, GENERIC_EPS_I2C_LOG_VERSION);
+        return 1;
+    }
+
+    /* Downstream simulators are not there, only count what would have been sent */
+    std::uint64_t notifications = 0;
+    Nos3::Generic_epsCore core(config, hdr.start_time, hdr.microseconds_per_tick,
+        [&notifications](std::uint8_t, bool) {notifications++;});
+    if (core.get_num_switches() != hdr.num_switches)
+    {
+        std::fprintf(stderr, "%s: %s was recorded with %d switches, the config has %d\n", argv[0], log_file, hdr.num_switches, core.get_num_switches());
+        return 1;
+    }
+    if (!checkpoint_file.empty())
+    {
+        Nos3::Generic_epsCheckpoint checkpoint;
+        if (!checkpoint.read(checkpoint_file) || !core.apply_checkpoint(checkpoint))
+        {
+            std::fprintf(stderr, "%s: %s is not a checkpoint with %d switches\n", argv[0], checkpoint_file.c_str(), core.get_num_switches());
+            return 1;
+        }
+    }
+
+    Nos3::Generic_epsSunVector sun;
+    sun.x = sun.y = sun.z = 0.0;
+    sun.valid = false;
+    bool ticking = false; /* No tick before the first sun record */
+    std::uint64_t time = 0;
+    std::uint64_t ticks = 0, transactions = 0, sun_changes = 0, mismatches = 0;
+    std::int64_t first_wall_ns = 0, last_wall_ns = 0;
+    Nos3::Generic_epsI2CResponse out_data;
+    std::size_t out_len;
+    std::size_t pos = sizeof(hdr);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (pos + sizeof(Nos3::Generic_epsI2CLogRecord) <= size)
+    {
+        Nos3::Generic_epsI2CLogRecord rec;
+        std::memcpy(&rec, base + pos, sizeof(rec));
+        std::size_t payload_len = GENERIC_EPS_I2C_LOG_ALIGN((std::size_t)rec.write_len + rec.read_len);
+        if (pos + sizeof(rec) + payload_len > size)
+        {
+            std::fprintf(stderr, "%s: log ends in a partial record, stopping there\n", argv[0]);
+            break;
+        }
+        const std::uint8_t* payload = base + pos + sizeof(rec);
+        pos += sizeof(rec) + payload_len;
+
+        if (transactions + sun_changes == 0)
+        {
+            first_wall_ns = rec.wall_ns;
+        }
+        last_wall_ns = rec.wall_ns;
+
+        if (rec.type == GENERIC_EPS_I2C_LOG_TYPE_SUN)
+        {
+            Nos3::Generic_epsI2CLogSun logged;
+            std::memcpy(&logged, payload, sizeof(logged));
+
+            /* Ticks up to this one ran at the previous sun, this tick at the logged one */
+            while (ticking && (time + 1 < rec.tick))
+            {
+                core.tick(sun, ++time);
+                ticks++;
+            }
+            sun.x = logged.x;
+            sun.y = logged.y;
+            sun.z = logged.z;
+            sun.valid = (logged.valid != 0);
+            time = rec.tick;
+            ticking = true;
+            core.tick(sun, time);
+            ticks++;
+            sun_changes++;
+        }
+        else if (rec.type == GENERIC_EPS_I2C_LOG_TYPE_I2C)
+        {
+            while (ticking && (time < rec.tick))
+            {
+                core.tick(sun, ++time);
+                ticks++;
+            }
+            std::uint8_t valid = core.determine_i2c_response_for_request(payload, rec.write_len, out_data, out_len);
+            if ((valid != rec.valid) || (out_len != rec.read_len) ||
+                (std::memcmp(out_data.data(), payload + rec.write_len, out_len) != 0))
+            {
+                if (mismatches < max_shown)
+                {
+                    print_mismatch(transactions, hdr.start_time + rec.tick * (hdr.microseconds_per_tick / 1000000.0), rec, payload, valid, out_data, out_len);
+                }
+                mismatches++;
+            }
+            transactions++;
+        }
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    munmap((void*)base, size);
+
+    std::printf("replayed %llu transactions, %llu sun changes, %llu ticks in %.3f s (%.0f transactions/s)\n",
+        (unsigned long long)transactions, (unsigned long long)sun_changes, (unsigned long long)ticks, wall, (wall > 0.0) ? transactions / wall : 0.0);
+    std::printf("recorded over %.3f s of wall time, %llu switch notifications\n",
+        (last_wall_ns - first_wall_ns) / 1000000000.0, (unsigned long long)notifications);
+    std::printf("%llu mismatches\n", (unsigned long long)mismatches);
+    return (mismatches == 0) ? 0 : 1;
+}
@@ -0,0 +1,508 @@
+/*
+** Time the simulator hot paths in isolation, with no NOS Engine or 42
+**
+** Usage: generic_eps_sim_bench [-c simulator config] [-s samples] [-f 42 frame]... [-o json file]
+**
+** Each case runs in samples of enough operations to take about 50 us.  The report gives the mean, minimum and
+** percentile ns/op over the samples, and heap allocations per operation counted through operator new.
+** 42 frames are text files of one frame as 42 writes it to its socket; without -f, frames of 1, 8 and 64
+** spacecraft are made up.  JSON goes to stdout unless -o is given, a summary table goes to stderr.
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include <generic_eps_batch.hpp>
+#include <generic_eps_core.hpp>
+#include <generic_eps_data_point.hpp>
+
+#define GENERIC_EPS_BENCH_SAMPLE_NS     50000.0
+#define GENERIC_EPS_BENCH_MAX_BATCH     (1 << 24)
+
+namespace Nos3
+{
+    /* Stand-in for the sim_common logger, main gates every message off before it is reached */
+    ItcLogger::Logger *sim_logger = NULL;
+}
+
+/*
+** Every allocation in the process, sampled around each case
+** Kept out of line so the compiler does not pair inlined malloc and free with new and delete expressions
+*/
+#define GENERIC_EPS_BENCH_NOINLINE __attribute__((noinline))
+
+static std::atomic<std::uint64_t> g_allocs(0);
+
+GENERIC_EPS_BENCH_NOINLINE void* operator new(std::size_t size)
+{
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size ? size : 1);
+    if (p == NULL)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+GENERIC_EPS_BENCH_NOINLINE void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+GENERIC_EPS_BENCH_NOINLINE void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+GENERIC_EPS_BENCH_NOINLINE void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+GENERIC_EPS_BENCH_NOINLINE void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+GENERIC_EPS_BENCH_NOINLINE void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+/* Keeps results live so the measured work is not optimized away */
+static volatile std::uint64_t g_sink;
+
+namespace
+{
+    struct BenchResult
+    {
+        std::string   name;
+        std::uint64_t ops;
+        double        mean;
+        double        min;
+        double        p50;
+        double        p90;
+        double        p99;
+        double        max;
+        double        allocs_per_op;
+    };
+
+    /* Stand-in for the data provider typed path, the sun turns slowly like a spinning spacecraft */
+    class BenchSunSource : public Nos3::Generic_epsSunVectorSource
+    {
+    public:
+        BenchSunSource(void) : _n(0) {}
+        Nos3::Generic_epsSunVector get_sun_vector(void) const
+        {
+            Nos3::Generic_epsSunVector sun;
+            double angle = (_n++ / 100) * 0.01; /* 42 updates every 100 ticks */
+            sun.x = std::cos(angle);
+            sun.y = std::sin(angle);
+            sun.z = 0.0;
+            sun.valid = true;
+            return sun;
+        }
+    private:
+        mutable std::uint64_t _n;
+    };
+
+    double percentile(const std::vector<double>& sorted, double p)
+    {
+        std::size_t i = (std::size_t)(p * (sorted.size() - 1) + 0.5);
+        return sorted[i];
+    }
+
+    /* Run op in batches sized to the sample time, op gets a running operation number */
+    template <typename Op>
+    BenchResult run(const std::string& name, std::size_t samples, Op op)
+    {
+        BenchResult r;
+        std::vector<double> ns_per_op;
+        std::uint64_t batch = 1;
+        std::uint64_t n = 0;
+        std::uint64_t i;
+        std::size_t s;
+
+        /* Warm up and grow the batch until a sample is long enough to time */
+        for (;;)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (i = 0; i < batch; i++)
+            {
+                op(n++);
+            }
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            if ((ns >= GENERIC_EPS_BENCH_SAMPLE_NS) || (batch >= GENERIC_EPS_BENCH_MAX_BATCH))
+            {
+                break;
+            }
+            batch *= 2;
+        }
+
+        ns_per_op.reserve(samples);
+        std::uint64_t allocs = g_allocs.load(std::memory_order_relaxed);
+        for (s = 0; s < samples; s++)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for (i = 0; i < batch; i++)
+            {
+                op(n++);
+            }
+            ns_per_op.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / batch);
+        }
+        /* The sample vector was reserved, so only the measured operations allocate in between */
+        allocs = g_allocs.load(std::memory_order_relaxed) - allocs;
+
+        r.name = name;
+        r.ops = batch * samples;
+        r.mean = 0.0;
+        for (s = 0; s < samples; s++)
+        {
+            r.mean += ns_per_op[s];
+        }
+        r.mean /= samples;
+        std::sort(ns_per_op.begin(), ns_per_op.end());
+        r.min = ns_per_op.front();
+        r.p50 = percentile(ns_per_op, 0.50);
+        r.p90 = percentile(ns_per_op, 0.90);
+        r.p99 = percentile(ns_per_op, 0.99);
+        r.max = ns_per_op.back();
+        r.allocs_per_op = (double)allocs / r.ops;
+        return r;
+    }
+
+    /* A 42 frame roughly as SimWriteToSocket lays it out, enough lines per spacecraft to make the search realistic */
+    std::vector<std::string> make_frame(int num_sc)
+    {
+        static const char* const names[] = {"PosN", "VelN", "qbn", "wbn", "Hvb", "bvb", "MassProps", "svn"};
+        std::vector<std::string> lines;
+        std::ostringstream line;
+        int sc, k;
+
+        lines.push_back("TIME 2026-290-12:00:00.000000000");
+        for (sc = 0; sc < num_sc; sc++)
+        {
+            for (k = 0; k < 8; k++)
+            {
+                line.str("");
+                line << "SC[" << sc << "]." << names[k] << " = " << 0.1 * k << " " << -0.2 * sc << " " << 0.3;
+                lines.push_back(line.str());
+            }
+            line.str("");
+            line << "SC[" << sc << "].svb = " << 0.267261 << " " << 0.534522 << " " << 0.801784;
+            lines.push_back(line.str());
+        }
+        lines.push_back("[EOF]");
+        return lines;
+    }
+
+    bool load_frame(const std::string& filename, std::vector<std::string>& lines)
+    {
+        std::ifstream in(filename.c_str());
+        std::string line;
+
+        if (!in)
+        {
+            return false;
+        }
+        lines.clear();
+        while (std::getline(in, line))
+        {
+            lines.push_back(line);
+        }
+        return true;
+    }
+
+    /* Highest spacecraft with an svb line, the single spacecraft parse looks for it so it scans the whole frame */
+    int last_spacecraft(const std::vector<std::string>& lines)
+    {
+        std::vector<Nos3::Generic_epsSunVector> sun;
+        Nos3::Generic_epsDataPoint::parse_sun_vectors(lines, sun);
+        return (int)sun.size() - 1;
+    }
+
+    void print_json(std::FILE* fp, const std::vector<BenchResult>& results)
+    {
+        std::size_t i;
+
+        std::fprintf(fp, "{\n  \"unit\": \"ns/op\",\n  \"benchmarks\": [\n");
+        for (i = 0; i < results.size(); i++)
+        {
+            const BenchResult& r = results[i];
+            std::fprintf(fp, "    {\"name\": \"%s\", \"ops\": %llu, \"mean\": %.2f, \"min\": %.2f, \"p50\": %.2f, \"p90\": %.2f, \"p99\": %.2f, \"max\": %.2f, \"allocs_per_op\": %.4f}%s\n",
+                r.name.c_str(), (unsigned long long)r.ops, r.mean, r.min, r.p50, r.p90, r.p99, r.max, r.allocs_per_op,
+                (i + 1 < results.size()) ? "," : "");
+        }
+        std::fprintf(fp, "  ]\n}\n");
+    }
+}
+
+static void usage(const char* name)
+{
+    std::fprintf(stderr, "Usage: %s [-c simulator config] [-s samples] [-f 42 frame]... [-o json file]\n", name);
+}
+
+int main(int argc, char* argv[])
+{
+    std::string config_file;
+    std::string json_file;
+    std::vector<std::string> frame_files;
+    std::size_t samples = 200;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:s:f:o:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'c': config_file = optarg; break;
+            case 's': samples = std::strtoul(optarg, NULL, 10); break;
+            case 'f': frame_files.push_back(optarg); break;
+            case 'o': json_file = optarg; break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if ((optind != argc) || (samples == 0))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    /* There is no logger behind sim_logger, gate everything before it */
+    Nos3::Generic_epsSimLog::set_level(GENERIC_EPS_SIM_LOG_OFF);
+
+    /* Defaults from the power model unless a config is given */
+    boost::property_tree::ptree config;
+    if (!config_file.empty() && !Nos3::Generic_epsBatch::load_config(config_file, config))
+    {
+        return 1;
+    }
+    std::int64_t tick_us = config.get("common.sim-microseconds-per-tick", 10000);
+
+    std::vector<BenchResult> results;
+    std::uint64_t notifications = 0;
+    Nos3::Generic_epsCore::SwitchNotify notify = [&notifications](std::uint8_t, bool) {notifications++;};
+
+    /* CRC of a command, of the HK frame for the configured switches, and of the largest HK frame */
+    {
+        Nos3::Generic_epsPowerModel power(config);
+        std::vector<std::uint8_t> data(GENERIC_EPS_SIM_HK_FRAME_MAX_LEN);
+        std::uint32_t lens[3] = {2, (std::uint32_t)GENERIC_EPS_SIM_HK_DATA_LEN(power.get_num_switches()), GENERIC_EPS_SIM_HK_DATA_LEN(GENERIC_EPS_POWER_MAX_SWITCHES)};
+        std::size_t i;
+        for (i = 0; i < data.size(); i++)
+        {
+            data[i] = (std::uint8_t)(i * 37 + 11);
+        }
+        for (i = 0; i < 3; i++)
+        {
+            std::uint32_t len = lens[i];
+            results.push_back(run("crc8_" + std::to_string(len), samples, [&data, len](std::uint64_t n)
+            {
+                data[0] = (std::uint8_t)n;
+                g_sink = GENERIC_EPS_CRC8(data.data(), len);
+            }));
+        }
+    }
+
+    /* I2C requests as the slave connection makes them */
+    {
+        Nos3::Generic_epsCore core(config, 0.0, tick_us, notify);
+        Nos3::Generic_epsI2CResponse out_data;
+        std::size_t out_len;
+        std::uint8_t hk[3] = {0x70, 0x00, 0x00};
+        hk[2] = GENERIC_EPS_CRC8(hk, 2);
+
+        /* First tick powers the other simulators, after it switch changes are sent as in a run */
+        Nos3::Generic_epsSunVector sun = {0.0, 0.0, 0.0, true};
+        core.tick(sun, 1);
+
+        std::uint8_t num_switches = core.get_num_switches();
+        if (num_switches > 0)
+        {
+            results.push_back(run("i2c_switch", samples, [&core, &out_data, &out_len, num_switches](std::uint64_t n)
+            {
+                std::uint8_t req[3];
+                req[0] = (std::uint8_t)((n / 2) % num_switches);
+                req[1] = (n & 1) ? 0xAA : 0x00;
+                req[2] = GENERIC_EPS_CRC8(req, 2);
+                g_sink = core.determine_i2c_response_for_request(req, 3, out_data, out_len);
+
+                /* Switches wait for the writer, stand in for the tick that takes them */
+                if ((n % 32) == 31)
+                {
+                    core.apply_queued();
+                }
+            }));
+            core.apply_queued();
+        }
+        results.push_back(run("i2c_hk", samples, [&core, &hk, &out_data, &out_len](std::uint64_t)
+        {
+            g_sink = core.determine_i2c_response_for_request(hk, 3, out_data, out_len) + out_data[1];
+        }));
+
+        /* HK read back right after a switch command, before a tick has taken it */
+        if (num_switches > 0)
+        {
+            std::uint8_t req[3] = {0x00, 0xAA, 0x00};
+            req[2] = GENERIC_EPS_CRC8(req, 2);
+            core.determine_i2c_response_for_request(req, 3, out_data, out_len);
+            results.push_back(run("i2c_hk_queued", samples, [&core, &hk, &out_data, &out_len](std::uint64_t)
+            {
+                g_sink = core.determine_i2c_response_for_request(hk, 3, out_data, out_len) + out_data[1];
+            }));
+            core.apply_queued();
+        }
+    }
+
+    /* HK frame encoding after a battery change and after a full state change such as a checkpoint load */
+    {
+        Nos3::Generic_epsPowerModel power(config);
+        Nos3::Generic_epsHkFrame frame(power.get_num_switches());
+        Nos3::Generic_epsSunVector sun = {1.0, 0.0, 0.0, true};
+        std::uint8_t out[GENERIC_EPS_SIM_HK_FRAME_MAX_LEN];
+
+        results.push_back(run("hk_publish_battery", samples, [&power, &frame, &sun, &out](std::uint64_t)
+        {
+            power.step(1.0, sun);
+            frame.mark_dirty(GENERIC_EPS_SIM_SEG_BUS(0));
+            frame.publish(&power.get_bus(0), power.get_switches());
+            frame.copy(out);
+            g_sink = out[0];
+        }));
+        results.push_back(run("hk_publish_all", samples, [&power, &frame, &out](std::uint64_t)
+        {
+            frame.mark_all_dirty();
+            frame.publish(&power.get_bus(0), power.get_switches());
+            frame.copy(out);
+            g_sink = out[0];
+        }));
+    }
+
+    /* Time tick with the sun from a provider, stepping every tick and with event integration */
+    {
+        const char* const modes[2] = {"tick", "event"};
+        std::size_t i;
+        for (i = 0; i < 2; i++)
+        {
+            boost::property_tree::ptree tick_config = config;
+            tick_config.put("simulator.hardware-model.integration", modes[i]);
+            Nos3::Generic_epsCore core(tick_config, 0.0, tick_us, notify);
+            BenchSunSource source;
+            results.push_back(run(std::string("tick_") + modes[i], samples, [&core, &source](std::uint64_t n)
+            {
+                core.tick(source.get_sun_vector(), n);
+            }));
+        }
+    }
+
+    /* Time tick of a multi model's 64 instances in one fleet, per tick for all of them */
+    {
+        Nos3::Generic_epsCoreFleet fleet(tick_us);
+        std::vector<std::unique_ptr<Nos3::Generic_epsCore> > cores;
+        std::vector<Nos3::Generic_epsSunVector> suns(64);
+        std::size_t i;
+        for (i = 0; i < suns.size(); i++)
+        {
+            cores.emplace_back(new Nos3::Generic_epsCore(config, 0.0, tick_us, notify, &fleet));
+        }
+        BenchSunSource source;
+        results.push_back(run("tick_fleet_64", samples, [&fleet, &suns, &source](std::uint64_t n)
+        {
+            Nos3::Generic_epsSunVector sun = source.get_sun_vector();
+            std::size_t j;
+            for (j = 0; j < suns.size(); j++)
+            {
+                suns[j] = sun;
+                suns[j].z = j * 0.01;
+            }
+            fleet.tick(suns.data(), n);
+        }));
+    }
+
+    /* 42 frame parsing, one spacecraft and every spacecraft in a pass */
+    {
+        std::vector<std::vector<std::string> > frames;
+        std::size_t i;
+        if (frame_files.empty())
+        {
+            frames.push_back(make_frame(1));
+            frames.push_back(make_frame(8));
+            frames.push_back(make_frame(64));
+        }
+        for (i = 0; i < frame_files.size(); i++)
+        {
+            frames.push_back(std::vector<std::string>());
+            if (!load_frame(frame_files[i], frames.back()))
+            {
+                std::fprintf(stderr, "%s: unable to read %s\n", argv[0], frame_files[i].c_str());
+                return 1;
+            }
+        }
+        for (i = 0; i < frames.size(); i++)
+        {
+            const std::vector<std::string>& lines = frames[i];
+            std::size_t bytes = 0;
+            std::size_t j;
+            for (j = 0; j < lines.size(); j++)
+            {
+                bytes += lines[j].size() + 1;
+            }
+            std::string size = std::to_string(bytes) + "B";
+
+            int sc = last_spacecraft(lines);
+            if (sc < 0)
+            {
+                std::fprintf(stderr, "%s: frame %zu has no SC[n].svb lines, skipped\n", argv[0], i);
+                continue;
+            }
+            std::string prefix = "SC[" + std::to_string(sc) + "].svb = ";
+            results.push_back(run("parse_svb_" + size, samples, [&lines, &prefix](std::uint64_t)
+            {
+                g_sink = Nos3::Generic_epsDataPoint::parse_sun_vector(prefix, lines).valid;
+            }));
+
+            std::vector<Nos3::Generic_epsSunVector> by_spacecraft;
+            results.push_back(run("parse_svb_all_" + size, samples, [&lines, &by_spacecraft](std::uint64_t)
+            {
+                Nos3::Generic_epsDataPoint::parse_sun_vectors(lines, by_spacecraft);
+                g_sink = by_spacecraft.size();
+            }));
+        }
+    }
+
+    std::size_t i;
+    std::fprintf(stderr, "%-24s %12s %10s %10s %10s %10s %10s\n", "case", "ops", "mean", "p50", "p90", "p99", "allocs/op");
+    for (i = 0; i < results.size(); i++)
+    {
+        std::fprintf(stderr, "%-24s %12llu %10.1f %10.1f %10.1f %10.1f %10.3f\n", results[i].name.c_str(),
+            (unsigned long long)results[i].ops, results[i].mean, results[i].p50, results[i].p90, results[i].p99, results[i].allocs_per_op);
+    }
+
+    if (json_file.empty())
+    {
+        print_json(stdout, results);
+    }
+    else
+    {
+        std::FILE* fp = std::fopen(json_file.c_str(), "w");
+        if (fp == NULL)
+        {
+            std::fprintf(stderr, "%s: unable to write %s\n", argv[0], json_file.c_str());
+            return 1;
+        }
+        print_json(fp, results);
+        std::fclose(fp);
+    }
+    return 0;
+}
@@ -0,0 +1,307 @@
+/*
+** Drive one EPS core from a tick thread and an I2C thread at once, with no NOS Engine or 42
+**
+** Usage: generic_eps_stress [-c simulator config] [-d seconds] [-p switch command percent] [-t tick period us] [-b backdoor period us]
+**
+** The tick thread steps the power model flat out (or every -t us) under a changing sun.  The I2C thread sends
+** HK requests and, -p percent of the time, switch commands, as the slave callback does.  Every HK frame is
+** checked: its CRC, the switch mask against the last commands sent, each switch's voltage and current
+** against its state, and the fixed rails against the config.  A torn or mixed frame fails at least one.
+** With -b a third thread sends a backdoor GET every period, taking the writer role from the tick.
+** The writer counts show how many ticks were handed to a command and how many switch commands found the
+** queue full because no tick had run; those are refused as the device would and are not failures.
+** Exits 1 if any frame failed.
+*/
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include <generic_eps_backdoor.hpp>
+#include <generic_eps_batch.hpp>
+#include <generic_eps_core.hpp>
+
+namespace Nos3
+{
+    /* Debug logging is gated off in main, nothing is written through it */
+    ItcLogger::Logger *sim_logger = NULL;
+}
+
+namespace
+{
+    struct StressCounts
+    {
+        std::uint64_t frames;
+        std::uint64_t switch_commands;
+        std::uint64_t refused;
+        std::uint64_t bad_crc;
+        std::uint64_t bad_mask;
+        std::uint64_t bad_switch;
+        std::uint64_t bad_bus;
+        std::uint64_t bad_response;
+    };
+
+    std::uint16_t get_u16(const std::uint8_t* data)
+    {
+        return (std::uint16_t)((data[0] << 8) | data[1]);
+    }
+
+    /* Sends one request the way the slave connection does, returns false if the core did not accept it */
+    bool request(Nos3::Generic_epsCore& core, std::uint8_t cmd, std::uint8_t data, Nos3::Generic_epsI2CResponse& out_data, std::size_t& out_len)
+    {
+        std::uint8_t req[3] = {cmd, data, 0x00};
+        req[2] = GENERIC_EPS_CRC8(req, 2);
+        return core.determine_i2c_response_for_request(req, 3, out_data, out_len) == GENERIC_EPS_SIM_SUCCESS;
+    }
+
+    /* Fields of the HK frame that only a backdoor SET would change, taken before the threads start */
+    struct Expected
+    {
+        std::uint16_t battery_temperature;
+        std::uint16_t bus_voltage[3];
+        std::uint16_t solar_voltage;
+        std::uint16_t solar_temperature;
+        std::vector<std::uint16_t> switch_voltage;
+        std::vector<std::uint16_t> switch_current;
+    };
+
+    void check_frame(const Expected& expected, std::uint64_t mask, const std::uint8_t* frame, std::uint16_t frame_len, StressCounts& counts)
+    {
+        std::uint8_t num_switches = (std::uint8_t)expected.switch_voltage.size();
+        std::uint8_t i;
+
+        counts.frames++;
+        if (GENERIC_EPS_CRC8(frame, frame_len - 1) != frame[frame_len - 1])
+        {
+            counts.bad_crc++;
+        }
+
+        if ((get_u16(&frame[2]) != expected.battery_temperature) ||
+            (get_u16(&frame[4]) != expected.bus_voltage[0]) ||
+            (get_u16(&frame[6]) != expected.bus_voltage[1]) ||
+            (get_u16(&frame[8]) != expected.bus_voltage[2]) ||
+            (get_u16(&frame[12]) != expected.solar_voltage) ||
+            (get_u16(&frame[14]) != expected.solar_temperature))
+        {
+            counts.bad_bus++;
+        }
+
+        const std::uint8_t* mask_bytes = &frame[GENERIC_EPS_SIM_HK_HEADER_LEN];
+        const std::uint8_t* rails = mask_bytes + GENERIC_EPS_SIM_HK_MASK_LEN(num_switches);
+        bool mask_ok = true;
+        bool switch_ok = true;
+        for (i = 0; i < num_switches; i++)
+        {
+            bool on = ((mask >> i) & 1) != 0;
+            if ((((mask_bytes[i / 8] >> (i % 8)) & 1) != 0) != on)
+            {
+                mask_ok = false;
+            }
+            std::uint16_t voltage = get_u16(&rails[4 * i]);
+            std::uint16_t current = get_u16(&rails[4 * i + 2]);
+            if (on ? ((voltage != expected.switch_voltage[i]) || (current != expected.switch_current[i])) : ((voltage != 0) || (current != 0)))
+            {
+                switch_ok = false;
+            }
+        }
+        counts.bad_mask += mask_ok ? 0 : 1;
+        counts.bad_switch += switch_ok ? 0 : 1;
+    }
+}
+
+static void usage(const char* name)
+{
+    std::fprintf(stderr, "Usage: %s [-c simulator config] [-d seconds] [-p switch command percent] [-t tick period us] [-b backdoor period us]\n", name);
+}
+
+int main(int argc, char* argv[])
+{
+    std::string config_file;
+    double duration = 5.0;
+    int switch_percent = 10;
+    long tick_period_us = 0;
+    long backdoor_period_us = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:d:p:t:b:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'c': config_file = optarg; break;
+            case 'd': duration = std::strtod(optarg, NULL); break;
+            case 'p': switch_percent = std::atoi(optarg); break;
+            case 't': tick_period_us = std::atol(optarg); break;
+            case 'b': backdoor_period_us = std::atol(optarg); break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if ((optind != argc) || (duration <= 0.0) || (switch_percent < 0) || (switch_percent > 100) || (tick_period_us < 0) || (backdoor_period_us < 0))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    /* There is no logger behind sim_logger, gate everything before it */
+    Nos3::Generic_epsSimLog::set_level(GENERIC_EPS_SIM_LOG_OFF);
+
+    /* Defaults from the power model unless a config is given */
+    boost::property_tree::ptree config;
+    if (!config_file.empty() && !Nos3::Generic_epsBatch::load_config(config_file, config))
+    {
+        return 1;
+    }
+
+    std::atomic<std::uint64_t> notifications(0);
+    Nos3::Generic_epsCore core(config, 0.0, config.get("common.sim-microseconds-per-tick", 10000),
+        [&notifications](std::uint8_t, bool) {notifications.fetch_add(1, std::memory_order_relaxed);});
+
+    /* Taken before the threads start, nothing else changes these */
+    const Nos3::Generic_epsPowerModel& power = core.get_power();
+    std::uint8_t num_switches = core.get_num_switches();
+    Expected expected;
+    std::uint8_t i;
+    expected.battery_temperature = power.get_bus(0)._temperature;
+    for (i = 0; i < 3; i++)
+    {
+        expected.bus_voltage[i] = power.get_bus(1 + i)._voltage;
+    }
+    expected.solar_voltage = power.get_bus(4)._voltage;
+    expected.solar_temperature = power.get_bus(4)._temperature;
+    for (i = 0; i < num_switches; i++)
+    {
+        expected.switch_voltage.push_back(power.get_switch(i)._voltage);
+        expected.switch_current.push_back(power.get_switch(i)._current);
+    }
+    std::uint64_t mask = power.get_switch_mask();
+
+    std::atomic<bool> stop(false);
+    std::atomic<std::uint64_t> ticks(0);
+    std::atomic<std::uint64_t> tick_ns(0);
+    std::atomic<std::uint64_t> tick_max_ns(0);
+
+    std::thread ticker([&]()
+    {
+        std::uint64_t time = 0;
+        std::uint64_t total = 0;
+        std::uint64_t worst = 0;
+        std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            /* In and out of eclipse so the battery charges and discharges and the frame keeps changing */
+            Nos3::Generic_epsSunVector sun;
+            sun.x = ((time % 200) < 100) ? 1.0 : 0.0;
+            sun.y = 0.0;
+            sun.z = 0.0;
+            sun.valid = true;
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            core.tick(sun, ++time);
+            std::uint64_t ns = (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            total += ns;
+            worst = (ns > worst) ? ns : worst;
+
+            if (tick_period_us > 0)
+            {
+                next += std::chrono::microseconds(tick_period_us);
+                std::this_thread::sleep_until(next);
+            }
+        }
+        ticks.store(time, std::memory_order_relaxed);
+        tick_ns.store(total, std::memory_order_relaxed);
+        tick_max_ns.store(worst, std::memory_order_relaxed);
+    });
+
+    /* Reads only, so the frame checks still hold */
+    std::atomic<std::uint64_t> commands(0);
+    std::thread backdoor([&]()
+    {
+        Nos3::Generic_epsBackdoor table(num_switches);
+        Nos3::Generic_epsBackdoorRequest get;
+        std::string error;
+        if ((backdoor_period_us == 0) || !table.parse("GET *", get, error))
+        {
+            return;
+        }
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            core.execute(get);
+            commands.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::sleep_for(std::chrono::microseconds(backdoor_period_us));
+        }
+    });
+
+    StressCounts counts;
+    std::memset(&counts, 0, sizeof(counts));
+    std::uint64_t i2c_ns = 0;
+    std::uint64_t i2c_max_ns = 0;
+    {
+        std::mt19937 rng(1);
+        std::uniform_int_distribution<int> percent(0, 99);
+        std::uniform_int_distribution<int> pick(0, (num_switches > 0) ? num_switches - 1 : 0);
+        Nos3::Generic_epsI2CResponse out_data;
+        std::size_t out_len;
+        std::uint16_t frame_len = core.get_frame_len();
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() +
+            std::chrono::microseconds((std::int64_t)(duration * 1000000.0));
+
+        while (std::chrono::steady_clock::now() < end)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            if ((num_switches > 0) && (percent(rng) < switch_percent))
+            {
+                /* Toggle one switch, the next frames must show it */
+                std::uint8_t sw_num = (std::uint8_t)pick(rng);
+                bool on = ((mask >> sw_num) & 1) == 0;
+                if (request(core, sw_num, on ? 0xAA : 0x00, out_data, out_len))
+                {
+                    mask ^= (std::uint64_t)1 << sw_num;
+                    counts.switch_commands++;
+                }
+                else
+                {
+                    counts.refused++;
+                }
+            }
+            else if (request(core, 0x70, 0x00, out_data, out_len) && (out_len == frame_len))
+            {
+                check_frame(expected, mask, out_data.data(), frame_len, counts);
+            }
+            else
+            {
+                counts.bad_response++;
+            }
+            std::uint64_t ns = (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            i2c_ns += ns;
+            i2c_max_ns = (ns > i2c_max_ns) ? ns : i2c_max_ns;
+        }
+    }
+    stop.store(true, std::memory_order_relaxed);
+    ticker.join();
+    backdoor.join();
+
+    Nos3::Generic_epsWriterStats writer = core.get_writer_stats();
+    std::uint64_t requests = counts.frames + counts.switch_commands + counts.refused + counts.bad_response;
+    std::uint64_t failures = counts.bad_crc + counts.bad_mask + counts.bad_switch + counts.bad_bus + counts.bad_response;
+
+    std::printf("ticks %llu, mean %.0f ns, max %.1f us\n", (unsigned long long)ticks.load(),
+        (ticks.load() > 0) ? (double)tick_ns.load() / ticks.load() : 0.0, tick_max_ns.load() / 1000.0);
+    std::printf("i2c requests %llu (%llu HK frames, %llu switch commands, %llu refused), mean %.0f ns, max %.1f us, %llu switch notifications\n",
+        (unsigned long long)requests, (unsigned long long)counts.frames, (unsigned long long)counts.switch_commands, (unsigned long long)counts.refused,
+        (requests > 0) ? (double)i2c_ns / requests : 0.0, i2c_max_ns / 1000.0, (unsigned long long)notifications.load());
+    std::printf("state writes %llu, backdoor commands %llu, ticks handed off %llu, I2C requests queued %llu, refused %llu\n",
+        (unsigned long long)writer.writes, (unsigned long long)commands.load(), (unsigned long long)writer.handed_off,
+        (unsigned long long)writer.queued, (unsigned long long)writer.refused);
+    std::printf("bad crc %llu, bad mask %llu, bad switch rails %llu, bad bus rails %llu, rejected requests %llu\n",
+        (unsigned long long)counts.bad_crc, (unsigned long long)counts.bad_mask, (unsigned long long)counts.bad_switch,
+        (unsigned long long)counts.bad_bus, (unsigned long long)counts.bad_response);
+
+    return (failures == 0) ? 0 : 1;
+}
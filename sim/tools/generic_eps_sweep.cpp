@@ -0,0 +1,289 @@
+/*
+** Monte Carlo sweep of the EPS power model over its physical parameters
+**
+** Usage: generic_eps_sweep -p params [-n runs] [-j threads] [-S seed] [-s schedule] [-d seconds] [-m tick|event]
+**                          [-k microseconds] [-t threshold] [-o results csv] <simulator config>
+**
+** Parameter lines are "<key> fixed <value>", "<key> uniform <min> <max>" or "<key> normal <mean> <sd>",
+** '#' starts a comment.  Keys are relative to simulator.hardware-model.physical, for example
+** bus.battery-watt-hrs or switch-3.current, and initial-soc sets the starting charge as a
+** fraction of battery-watt-hrs.
+**
+** Run n samples its parameters from a generator seeded with the base seed and n, so any run can be
+** reproduced alone and the results do not depend on the thread count.  The threshold is a state of
+** charge fraction, time below it is reported per run.
+*/
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include <generic_eps_batch.hpp>
+#include <generic_eps_work_pool.hpp>
+
+#define GENERIC_EPS_SWEEP_SOC_KEY "initial-soc"
+
+struct Generic_epsSweepParam
+{
+    std::string key;
+    enum {FIXED, UNIFORM, NORMAL} dist;
+    double a;
+    double b;
+};
+
+/* One slot per run, written only by the worker that ran it */
+struct Generic_epsSweepRun
+{
+    Nos3::Generic_epsBatchResult result;
+    double min_soc;
+    double final_soc;
+};
+
+static bool load_params(const std::string& filename, std::vector<Generic_epsSweepParam>& params)
+{
+    std::ifstream in(filename.c_str());
+    std::string line;
+    unsigned line_num = 0;
+
+    if (!in)
+    {
+        std::fprintf(stderr, "%s: unable to open\n", filename.c_str());
+        return false;
+    }
+
+    while (std::getline(in, line))
+    {
+        line_num++;
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields(line);
+        Generic_epsSweepParam p;
+        std::string dist;
+        if (!(fields >> p.key))
+        {
+            continue; /* Blank or comment */
+        }
+
+        bool ok = (bool)(fields >> dist >> p.a);
+        p.b = 0.0;
+        if (ok && (dist.compare("fixed") == 0))
+        {
+            p.dist = Generic_epsSweepParam::FIXED;
+        }
+        else if (ok && (dist.compare("uniform") == 0))
+        {
+            p.dist = Generic_epsSweepParam::UNIFORM;
+            ok = (fields >> p.b) && (p.b >= p.a);
+        }
+        else if (ok && (dist.compare("normal") == 0))
+        {
+            p.dist = Generic_epsSweepParam::NORMAL;
+            ok = (fields >> p.b) && (p.b >= 0.0);
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            std::fprintf(stderr, "%s:%u: expected <key> fixed <value>, <key> uniform <min> <max> or <key> normal <mean> <sd>\n", filename.c_str(), line_num);
+            return false;
+        }
+        params.push_back(p);
+    }
+    return true;
+}
+
+static double sample(const Generic_epsSweepParam& p, std::mt19937_64& rng)
+{
+    switch (p.dist)
+    {
+        case Generic_epsSweepParam::UNIFORM:
+            return std::uniform_real_distribution<double>(p.a, p.b)(rng);
+        case Generic_epsSweepParam::NORMAL:
+            return (p.b > 0.0) ? std::normal_distribution<double>(p.a, p.b)(rng) : p.a;
+        default:
+            return p.a;
+    }
+}
+
+static double percentile(const std::vector<double>& sorted, double pct)
+{
+    std::size_t i = (std::size_t)(pct * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+static void usage(const char* name)
+{
+    std::fprintf(stderr, "Usage: %s -p params [-n runs] [-j threads] [-S seed] [-s schedule] [-d seconds] [-m tick|event] [-k microseconds per tick] [-t threshold soc] [-o results csv] <simulator config>\n", name);
+}
+
+int main(int argc, char* argv[])
+{
+    std::string param_file;
+    std::string schedule_file;
+    std::string result_file;
+    std::uint64_t runs = 1000;
+    unsigned threads = std::thread::hardware_concurrency();
+    std::uint64_t seed = 1;
+    double duration = 86400.0;
+    bool event_integration = true;
+    std::int64_t tick_us = 0;
+    double threshold = 0.3;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "p:n:j:S:s:d:k:t:o:m:h")) != -1)
+    {
+        switch (opt)
+        {
+            case 'p': param_file = optarg; break;
+            case 'n': runs = std::strtoull(optarg, NULL, 10); break;
+            case 'j': threads = std::atoi(optarg); break;
+            case 'S': seed = std::strtoull(optarg, NULL, 0); break;
+            case 's': schedule_file = optarg; break;
+            case 'd': duration = std::atof(optarg); break;
+            case 'm': event_integration = (std::string(optarg).compare("tick") != 0); break;
+            case 'k': tick_us = std::atoll(optarg); break;
+            case 't': threshold = std::atof(optarg); break;
+            case 'o': result_file = optarg; break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+    if ((optind != argc - 1) || param_file.empty() || (runs == 0))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    boost::property_tree::ptree config;
+    std::vector<Generic_epsSweepParam> params;
+    if (!Nos3::Generic_epsBatch::load_config(argv[optind], config) || !load_params(param_file, params))
+    {
+        return 1;
+    }
+
+    if (tick_us <= 0)
+    {
+        tick_us = config.get("common.sim-microseconds-per-tick", 10000);
+    }
+    if (tick_us <= 0)
+    {
+        std::fprintf(stderr, "%s: tick length must be positive\n", argv[0]);
+        return 1;
+    }
+
+    Nos3::Generic_epsBatch batch(tick_us, duration, event_integration);
+    if (!schedule_file.empty() && !batch.load_schedule(schedule_file))
+    {
+        return 1;
+    }
+
+    /* Preallocated, each run writes only its own slot, reduced after the join */
+    std::vector<Generic_epsSweepRun> results(runs);
+    std::vector<double> values(runs * params.size());
+    Nos3::Generic_epsWorkPool pool(threads);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    pool.run(runs, [&](std::uint64_t run, unsigned)
+    {
+        std::seed_seq seq = {(std::uint32_t)seed, (std::uint32_t)(seed >> 32), (std::uint32_t)run, (std::uint32_t)(run >> 32)};
+        std::mt19937_64 rng(seq);
+        boost::property_tree::ptree run_config = config;
+        double* run_values = &values[run * params.size()];
+        double soc = 1.0;
+        std::size_t i;
+        char text[32];
+
+        for (i = 0; i < params.size(); i++)
+        {
+            run_values[i] = sample(params[i], rng);
+            if (params[i].key.compare(GENERIC_EPS_SWEEP_SOC_KEY) == 0)
+            {
+                soc = run_values[i];
+            }
+            else
+            {
+                std::snprintf(text, sizeof(text), "%.17g", run_values[i]);
+                run_config.put("simulator.hardware-model.physical." + params[i].key, text);
+            }
+        }
+
+        Nos3::Generic_epsPowerModel power(run_config);
+        double max_watthrs = power.get_max_battery_watthrs();
+        power.set_battery_watthrs(soc * max_watthrs);
+
+        Generic_epsSweepRun& out = results[run];
+        out.result = batch.run(power, threshold * max_watthrs);
+        out.min_soc = out.result.min_watthrs / max_watthrs;
+        out.final_soc = out.result.final_watthrs / max_watthrs;
+    });
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    /* Reduce */
+    std::vector<double> min_soc(runs);
+    std::uint64_t worst = 0;
+    std::uint64_t below = 0;
+    double below_time = 0.0;
+    std::uint64_t run;
+    for (run = 0; run < runs; run++)
+    {
+        min_soc[run] = results[run].min_soc;
+        if (results[run].min_soc < results[worst].min_soc)
+        {
+            worst = run;
+        }
+        if (results[run].result.below_time > 0.0)
+        {
+            below++;
+        }
+        below_time += results[run].result.below_time;
+    }
+    std::sort(min_soc.begin(), min_soc.end());
+
+    if (!result_file.empty())
+    {
+        std::FILE* fp = std::fopen(result_file.c_str(), "w");
+        if (fp == NULL)
+        {
+            std::fprintf(stderr, "%s: unable to write %s\n", argv[0], result_file.c_str());
+            return 1;
+        }
+        std::size_t i;
+        std::fprintf(fp, "run");
+        for (i = 0; i < params.size(); i++)
+        {
+            std::fprintf(fp, ",%s", params[i].key.c_str());
+        }
+        std::fprintf(fp, ",min_soc,min_time,below_time,final_soc\n");
+        for (run = 0; run < runs; run++)
+        {
+            std::fprintf(fp, "%llu", (unsigned long long)run);
+            for (i = 0; i < params.size(); i++)
+            {
+                std::fprintf(fp, ",%.9g", values[run * params.size() + i]);
+            }
+            std::fprintf(fp, ",%.6f,%.3f,%.3f,%.6f\n", results[run].min_soc, results[run].result.min_time,
+                results[run].result.below_time, results[run].final_soc);
+        }
+        std::fclose(fp);
+    }
+
+    std::printf("runs %llu of %llu ticks on %u threads in %.3f s (%.0f ticks/s)\n",
+        (unsigned long long)runs, (unsigned long long)batch.get_ticks(), pool.get_workers(), wall,
+        (wall > 0.0) ? runs * batch.get_ticks() / wall : 0.0);
+    std::printf("min soc worst %.6f (run %llu), p5 %.6f, median %.6f\n",
+        results[worst].min_soc, (unsigned long long)worst, percentile(min_soc, 0.05), percentile(min_soc, 0.5));
+    std::printf("runs below %.3f soc %llu (%.2f%%), mean time below %.3f s\n",
+        threshold, (unsigned long long)below, 100.0 * below / runs, below_time / runs);
+    return 0;
+}
@@ -0,0 +1,36 @@
+/*
+** Decode a binary EPS trace written by the simulator into CSV on stdout
+**
+** Usage: generic_eps_trace_decode <trace file>
+*/
+#include <cstdio>
+#include <vector>
+
+#include <generic_eps_trace.hpp>
+
+int main(int argc, char* argv[])
+{
+    std::vector<Nos3::Generic_epsTraceRecord> recs;
+    std::size_t i;
+
+    if (argc != 2)
+    {
+        std::fprintf(stderr, "Usage: %s <trace file>\n", argv[0]);
+        return 1;
+    }
+
+    if (!Nos3::Generic_epsTrace::load(argv[1], recs))
+    {
+        std::fprintf(stderr, "%s: %s is not a valid version %d EPS trace\n", argv[0], argv[1], GENERIC_EPS_TRACE_VERSION);
+        return 1;
+    }
+
+    std::printf("sim_time,p_in,p_out,battery_watthrs,battery_mv,switch_mask\n");
+    for (i = 0; i < recs.size(); i++)
+    {
+        std::printf("%.6f,%.4f,%.4f,%.6f,%u,0x%016llx\n",
+            recs[i].sim_time, recs[i].p_in, recs[i].p_out, recs[i].battery_watthrs,
+            recs[i].battery_mv, (unsigned long long)recs[i].switch_mask);
+    }
+    return 0;
+}